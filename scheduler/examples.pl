@@ -3,16 +3,18 @@
 # EECS678
 # Adopted from CS 241 @ The University of Illinois
 
+# examples/<trace>-c<cores>-<scheme>.out is the output of running
+# examples/<trace>.csv; every +<option> before .out is passed as --<option>.
 for $file (<examples/*>){
-	if( $file =~ /proc(\d+)-c(\d+)-(\w+)\.out/){
+	if( $file =~ /(\w+)-c(\d+)-(\w+)((?:\+[\w=.-]+)*)\.out$/){
 	#	print "Proc $1 CORE $2 Proc $3\n";
-		`./simulator -c $2 -s $3 examples/proc$1.csv | tail -7 > output1`;
-		`tail -7 $file > output2`;
-		$diff = `diff output1 output2`;
+		$flags = join(" ", map { "--$_" } grep { $_ ne "" } split(/\+/, $4));
+		`./simulator -c $2 -s $3 $flags examples/$1.csv > output1`;
+		$diff = `diff output1 $file`;
 		if($diff){
 			print "Test file $file differs\n$diff";
 		}
 	}
 }
 #cleanup
-`rm output1 output2`;
+`rm output1`;
@@ -0,0 +1,70 @@
+#!/usr/bin/perl
+
+# Simulator benchmark: generates seeded synthetic traces with tracegen and
+# runs every scheme over them, printing one CSV line per run.
+#
+# Usage: ./simbench.pl [jobs ...]   (default: 10000 100000 1000000)
+# SIMBENCH_CORES, SIMBENCH_RATE and SIMBENCH_FLAGS override the core count,
+# the arrival rate passed to tracegen and extra simulator flags.
+#
+# Then every scheme streams SIMBENCH_STREAM_JOBS (default 1000000) jobs and
+# four times as many; streaming must not keep per-job state, so the peak
+# RSS of the longer run may not be more than 25% (plus 1 MB) above that of
+# the shorter one. The script exits with status 1 if it is.
+
+@sizes = @ARGV ? @ARGV : (10000, 100000, 1000000);
+@schemes = ("fcfs", "sjf", "psjf", "pri", "ppri", "rr4");
+$cores = $ENV{SIMBENCH_CORES} || 4;
+$rate = $ENV{SIMBENCH_RATE} || 0.9;
+$flags = $ENV{SIMBENCH_FLAGS} || "";
+$stream_jobs = $ENV{SIMBENCH_STREAM_JOBS} || 1000000;
+
+mkdir "bench-traces";
+print "jobs,scheme,cores,parse_seconds,parse_jobs_per_s,time_units,events,seconds,units_per_s,events_per_s,peak_rss_kb\n";
+
+for $jobs (@sizes){
+	$trace = "bench-traces/jobs-$jobs.trace";
+	system("./tracegen -n $jobs -s 1 -r $rate -p zipf:8:1.0 -b -o $trace") == 0
+		or die "tracegen failed for $jobs jobs\n";
+
+	for $scheme (@schemes){
+		$report = `./simulator -q -c $cores -s $scheme --event-driven --timing $flags $trace 2>&1 >/dev/null`;
+		($parse_s, $parse_rate) = $report =~ /(?:Loaded|Parsed|Streamed) \d+ job\(s\), [\d.]+ MB in ([\d.]+) s \([\d.]+ MB\/s, (\d+) jobs\/s\)/;
+		if($report =~ /Simulated (\d+) time unit\(s\) and (\d+) scheduler event\(s\) in ([\d.]+) s \((\d+) units\/s, (\d+) events\/s\), peak RSS (\d+) KB/){
+			print "$jobs,$scheme,$cores,$parse_s,$parse_rate,$1,$2,$3,$4,$5,$6\n";
+		}
+		else{
+			print STDERR "Run of $scheme over $jobs jobs failed:\n$report";
+		}
+	}
+	unlink $trace;
+}
+
+sub stream_rss {
+	my ($scheme, $trace) = @_;
+	my $report = `./simulator -q -c $cores -s $scheme --event-driven --stream --timing $flags $trace 2>&1 >/dev/null`;
+	return $report =~ /peak RSS (\d+) KB/ ? $1 : undef;
+}
+
+$failed = 0;
+for $jobs ($stream_jobs, 4 * $stream_jobs){
+	system("./tracegen -n $jobs -s 1 -r $rate -p zipf:8:1.0 -b -o bench-traces/stream-$jobs.trace") == 0
+		or die "tracegen failed for $jobs jobs\n";
+}
+print "\nstream_jobs,scheme,cores,peak_rss_kb,peak_rss_kb_4x\n";
+for $scheme (@schemes){
+	$small = stream_rss($scheme, "bench-traces/stream-$stream_jobs.trace");
+	$large = stream_rss($scheme, "bench-traces/stream-" . (4 * $stream_jobs) . ".trace");
+	if(!defined $small || !defined $large){
+		print STDERR "Streamed run of $scheme failed\n";
+		$failed = 1;
+		next;
+	}
+	print "$stream_jobs,$scheme,$cores,$small,$large\n";
+	if($large > $small * 1.25 + 1024){
+		print STDERR "Streaming $scheme grew from $small KB to $large KB: memory is not bounded\n";
+		$failed = 1;
+	}
+}
+unlink "bench-traces/stream-$stream_jobs.trace", "bench-traces/stream-" . (4 * $stream_jobs) . ".trace";
+exit $failed;
@@ -0,0 +1,89 @@
+/** @file csv2trace.c
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "libtrace/libtrace.h"
+
+/**
+  Converts a CSV job trace (like examples/proc1.csv) into the binary trace
+  format read by the simulator.
+ */
+int main(int argc, char **argv)
+{
+	if (argc != 3)
+	{
+		fprintf(stderr, "Usage: %s <input csv> <output trace>\n", argv[0]);
+		return 1;
+	}
+
+	trace_t reader;
+	if (trace_open(&reader, argv[1]) != 0 || reader.binary)
+	{
+		fprintf(stderr, "Unable to open CSV trace \"%s\".\n", argv[1]);
+		return 2;
+	}
+
+	FILE *out = fopen(argv[2], "wb");
+	if (out == NULL)
+	{
+		fprintf(stderr, "Unable to create \"%s\".\n", argv[2]);
+		return 2;
+	}
+
+	trace_header_t header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, TRACE_MAGIC, sizeof(header.magic));
+	header.version = TRACE_VERSION;
+	header.record_size = sizeof(trace_record_t);
+	header.flags = TRACE_SORTED;
+
+	// Reserve room for the header; it is rewritten once the totals are known
+	fwrite(&header, sizeof(header), 1, out);
+
+	trace_job_t job;
+	trace_record_t record;
+	int status;
+	int32_t last_arrival = 0;
+
+	header.checksum = TRACE_CHECKSUM_SEED;
+	while ((status = trace_next(&reader, &job)) == 1)
+	{
+		record.arrival_time = job.arrival_time;
+		record.run_time = job.run_time;
+		record.priority = job.priority;
+		record.deadline = job.deadline;
+
+		if (header.count > 0 && record.arrival_time < last_arrival)
+			header.flags &= ~TRACE_SORTED;
+		last_arrival = record.arrival_time;
+
+		header.checksum = trace_checksum_update(header.checksum, &record, sizeof(record));
+		fwrite(&record, sizeof(record), 1, out);
+		header.count++;
+	}
+
+	if (status < 0)
+	{
+		fprintf(stderr, "Illegal file format.\n");
+		fclose(out);
+		remove(argv[2]);
+		return 2;
+	}
+
+	fseek(out, 0, SEEK_SET);
+	fwrite(&header, sizeof(header), 1, out);
+
+	if (fclose(out) != 0)
+	{
+		fprintf(stderr, "Unable to write \"%s\".\n", argv[2]);
+		remove(argv[2]);
+		return 2;
+	}
+
+	trace_close(&reader);
+	printf("Converted %llu job(s) from \"%s\" to \"%s\".\n", (unsigned long long)header.count, argv[1], argv[2]);
+	return 0;
+}
@@ -0,0 +1,115 @@
+/** @file libhistogram.c
+ */
+
+#include <string.h>
+
+#include "libhistogram.h"
+
+/*
+ * Bucket of value: the value itself below 2^HISTOGRAM_SUB_BITS, otherwise
+ * its top HISTOGRAM_SUB_BITS bits offset by how far they were shifted.
+ */
+static int bucket_of(int value)
+{
+  if (value < 2 * HISTOGRAM_HALF_BUCKETS)
+    return value;
+
+  int shift = 31 - __builtin_clz(value) - (HISTOGRAM_SUB_BITS - 1);
+  return shift * HISTOGRAM_HALF_BUCKETS + (value >> shift);
+}
+
+/* Largest value that falls in bucket. */
+static int bucket_top(int bucket)
+{
+  if (bucket < 2 * HISTOGRAM_HALF_BUCKETS)
+    return bucket;
+
+  int shift = bucket / HISTOGRAM_HALF_BUCKETS - 1;
+  long long low = (long long)(bucket - shift * HISTOGRAM_HALF_BUCKETS) << shift;
+  return low + (1LL << shift) - 1;
+}
+
+
+/**
+  Empties a histogram.
+
+  @param h a pointer to an instance of the histogram_t data structure
+ */
+void histogram_init(histogram_t *h)
+{
+  memset(h, 0, sizeof(histogram_t));
+}
+
+
+/**
+  Counts one value. Negative values are counted as 0.
+
+  @param h a pointer to an instance of the histogram_t data structure
+  @param value the value to record
+ */
+void histogram_record(histogram_t *h, int value)
+{
+  if (value < 0)
+    value = 0;
+
+  h->counts[bucket_of(value)]++;
+  if (h->count == 0 || value < h->min)
+    h->min = value;
+  if (h->count == 0 || value > h->max)
+    h->max = value;
+  h->count++;
+  h->sum += value;
+}
+
+
+/**
+  Returns the rank-th smallest recorded value: the top of the bucket that
+  holds it, but never more than the largest recorded value.
+
+  @param h a pointer to an instance of the histogram_t data structure
+  @param rank the rank, 1 to the number of recorded values
+  @return the value, 0 if nothing was recorded
+ */
+int histogram_value_at(const histogram_t *h, long long rank)
+{
+  long long seen = 0;
+
+  if (h->count == 0)
+    return 0;
+
+  for(int bucket = 0; bucket < HISTOGRAM_BUCKETS; bucket++){
+    seen += h->counts[bucket];
+    if (seen >= rank)
+      return bucket_top(bucket) < h->max ? bucket_top(bucket) : h->max;
+  }
+  return h->max;
+}
+
+
+/**
+  Returns the value below which permille thousandths of the recorded
+  values fall (nearest rank), e.g. 500 for the median and 999 for p99.9.
+  See histogram_value_at() for how the value is rounded.
+
+  @param h a pointer to an instance of the histogram_t data structure
+  @param permille the percentile in thousandths, 1 to 1000
+  @return the percentile, 0 if nothing was recorded
+ */
+int histogram_percentile(const histogram_t *h, int permille)
+{
+  long long rank = (h->count * permille + 999) / 1000;
+
+  return histogram_value_at(h, rank < 1 ? 1 : rank);
+}
+
+
+/**
+  Returns the exact mean of the recorded values.
+
+  @param h a pointer to an instance of the histogram_t data structure
+  @return the mean, 0 if nothing was recorded
+ */
+double histogram_mean(const histogram_t *h)
+{
+  return h->count > 0 ? (double)h->sum / h->count : 0.0;
+}
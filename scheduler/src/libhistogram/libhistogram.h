@@ -0,0 +1,38 @@
+/** @file libhistogram.h
+ */
+
+#ifndef LIBHISTOGRAM_H_
+#define LIBHISTOGRAM_H_
+
+/*
+ * Values below 2^HISTOGRAM_SUB_BITS get a bucket each. Above that every
+ * power of two is split into 2^(HISTOGRAM_SUB_BITS - 1) equal buckets, so
+ * a recorded value is off by less than 1/64 of itself (1.6%).
+ */
+#define HISTOGRAM_SUB_BITS 7
+#define HISTOGRAM_HALF_BUCKETS (1 << (HISTOGRAM_SUB_BITS - 1))
+#define HISTOGRAM_BUCKETS ((32 - HISTOGRAM_SUB_BITS + 1) * HISTOGRAM_HALF_BUCKETS)
+
+/**
+  Log-linear histogram of non-negative int values in the style of
+  HdrHistogram: constant memory and constant-time recording whatever the
+  number or range of values, with percentiles accurate to a fixed
+  relative error. Count, sum, minimum and maximum are exact.
+*/
+typedef struct _histogram_t
+{
+  long long counts[HISTOGRAM_BUCKETS];
+  long long count;
+  long long sum;
+  int min;
+  int max;
+} histogram_t;
+
+
+void   histogram_init      (histogram_t *h);
+void   histogram_record    (histogram_t *h, int value);
+int    histogram_value_at  (const histogram_t *h, long long rank);
+int    histogram_percentile(const histogram_t *h, int permille);
+double histogram_mean      (const histogram_t *h);
+
+#endif /* LIBHISTOGRAM_H_ */
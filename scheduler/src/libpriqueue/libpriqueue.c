@@ -1,303 +1,1114 @@
-/** @file libpriqueue.c
- */
-
-#include <stdlib.h>
-#include <stdio.h>
-
-#include "libpriqueue.h"
-
-// static node* make_nodes(void* ptr)
-// {
-// 	node* new_node = (node*) malloc(sizeof(node));
-// 	new_node->process = ptr;
-// 	new_node->next = NULL;
-// 	return new_node;
-// }
-/**
-  Initializes the priqueue_t data structure.
-
-  Assumtions
-    - You may assume this function will only be called once per instance of priqueue_t
-    - You may assume this function will be the first function called using an instance of priqueue_t.
-  @param q a pointer to an instance of the priqueue_t data structure
-  @param comparer a function pointer that compares two elements.
-  See also @ref comparer-page
- */
-void priqueue_init(priqueue_t *q, int(*comparer)(const void *, const void *))
-{
-	q->comp = comparer;
-	q->size = 0;
-	q->head = NULL;
-}
-
-
-/**
-  Inserts the specified element into this priority queue.
-
-  @param q a pointer to an instance of the priqueue_t data structure
-  @param ptr a pointer to the data to be inserted into the priority queue
-  @return The zero-based index where ptr is stored in the priority queue,
-	where 0 indicates that ptr was stored at the front of the priority queue.
- */
-int priqueue_offer(priqueue_t *q, void *ptr)
-{
-	node n_node = malloc(sizeof(node));
-  n_node->process = ptr;
-  n_node->next = NULL;
-  if(q->size == 0)
-  {
-    q->head = n_node;
-		q->size++;
-		return 0;
-  }
-
-	temp = q->head;
-  previous = NULL;
-
-  int location = 0;
-  while(temp != NULL && q->comp(temp->process,ptr) < 0)
-  {
-    previous = temp;
-    temp = temp->next;
-    location++;
-  }
-  if(location == 0)
-  {
-    q->size++;
-    n_node->next = q->head;
-    q->head = n_node;
-    return 0;
-  }
-
-  previous->next = n_node;
-  n_node->next = temp;
-
-  q->size++;
-	return location;
-}
-
-
-/**
-  Retrieves, but does not remove, the head of this queue, returning NULL if
-  this queue is empty.
-
-  @param q a pointer to an instance of the priqueue_t data structure
-  @return pointer to element at the head of the queue
-  @return NULL if the queue is empty
- */
-void *priqueue_peek(priqueue_t *q)
-{
-	if(q->size == 0)
-	{
-		return NULL;
-	}
-	else
-	{
-		return q->head->process;
-	}
-}
-
-
-/**
-  Retrieves and removes the head of this queue, or NULL if this queue
-  is empty.
-
-  @param q a pointer to an instance of the priqueue_t data structure
-  @return the head of this queue
-  @return NULL if this queue is empty
- */
-void *priqueue_poll(priqueue_t *q)
-{
-	if(q->size == 0)
-	{
-		return NULL;
-	}
-	temp = q->head;
-	void* return_process = NULL;
-
-	if (temp != NULL){
-		q->head = temp->next;
-	}
-	else {
-		q->head = NULL;
-	}
-	return_process = temp->process;
-	free(temp);
-	q->size--;
-	return return_process;
-	/*else{
-		temp = q->head;
-		void* return_process = temp->process;
-		q->head = temp->next;
-		q->size--;
-		free(temp);
-		return return_process;
-	}*/
-		// this node might need to be freed, to solve it I would create an accessor
-		// function to get the value and free it.
-}
-
-
-/**
-  Returns the element at the specified position in this list, or NULL if
-  the queue does not contain an index'th element.
-
-  @param q a pointer to an instance of the priqueue_t data structure
-  @param index position of retrieved element
-  @return the index'th element in the queue
-  @return NULL if the queue does not contain the index'th element
- */
-void *priqueue_at(priqueue_t *q, int index)
-{
-	if(index >= q->size)
-	{
-		return NULL;
-	}
-	else
-	{
-		temp = q->head;
-		int tracker = 1;
-		while(tracker <= index)
-		{
-			temp = temp->next;
-			tracker++;
-		}
-		/*if (index == tracker)
-			return temp;
-		else
-			return NULL;*/
-		return temp->process;
-	}
-}
-
-
-/**
-  Removes all instances of ptr from the queue.
-
-  This function should not use the comparer function,
-	but check if the data contained in each element of the queue is equal (==) to ptr.
-
-  @param q a pointer to an instance of the priqueue_t data structure
-  @param ptr address of element to be removed
-  @return the number of entries removed
- */
-int priqueue_remove(priqueue_t *q, void *ptr)
-{
-	int num_deleted = 0;
-	if (q->size == 0)
-		return 0;
-	temp = q->head;
-	if(q->comp(ptr, temp->process) == 0){
-		q->head = temp->next;
-		free(temp);
-		q->size--;
-		return priqueue_remove(q, ptr) + 1;
-	}
-
-	current = temp->next;
-	previous = temp;
-
-	while (current != NULL) {
-		if(q->comp(current->process, ptr) == 0){
-			num_deleted++;
-			temp = current->next;
-			previous->next = temp;
-			free(current);
-			current = temp;
-			q->size--;
-			}
-		else{
-			previous = current;
-			current = current->next;
-		}
-	}
-	return num_deleted;
-				/*else
-	{
-		while(q->head->process == ptr)
-		{
-			priqueue_poll(q);
-			num_deleted++;
-		}
-		current = q->head;
-		while(current != NULL)
-		{
-			temp = current ->next;
-			if(temp->process == ptr)
-			{
-				current->next = temp -> next;
-				free(temp);
-				q->size--;
-				num_deleted++;
-			}
-			current = current->next;
-		}*/
-//	}//end while
-		//return num_deleted;
-}
-
-
-
-/**
-  Removes the specified index from the queue, moving later elements up
-  a spot in the queue to fill the gap.
-
-  @param q a pointer to an instance of the priqueue_t data structure
-  @param index position of element to be removed
-  @return the element removed from the queue
-  @return NULL if the specified index does not exist
- */
-void *priqueue_remove_at(priqueue_t *q, int index)
-{
-	if(index < 0 || index > q->size)
-	{
-		return NULL;
-	}
-	//I do not really think it is a good way to do it, remember how to delete elem in linkedlist
-	node delEle = q->head;
-	//previous = current;
-	int tracker = 0;
-	while(tracker < index)
-	{
-		current = delEle;
-		delEle = delEle->next;
-		tracker++;
-	}
-	void* process_deleted = delEle->process;
-	current = delEle -> next;
-	free(delEle);
-	q->size--;
-	return process_deleted;
-}
-
-
-/**
-  Returns the number of elements in the queue.
-
-  @param q a pointer to an instance of the priqueue_t data structure
-  @return the number of elements in the queue
- */
-int priqueue_size(priqueue_t *q)
-{
-	return q->size;
-}
-
-
-/**
-  Destroys and frees all the memory associated with q.
-
-  @param q a pointer to an instance of the priqueue_t data structure
- */
-void priqueue_destroy(priqueue_t *q)
-{
-	current = q->head;
-	//previous = q->head;
-	while(q->size > 0)
-	{
-		temp = current->next;
-		free(current);
-		current = temp;
-		q->size--;
-	}
-	q->head = NULL;
-}
+/** @file libpriqueue.c
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define KEYED_AVX2
+#endif
+
+#include "libpriqueue.h"
+#include "libpriqueue_heap.h"
+
+#define HEAP_INITIAL_CAPACITY 16
+#define POOL_INITIAL_NODES 32
+#define POOL_MAX_CHUNK_NODES 4096
+
+#define KEYED_ARITY 8 // children per node: one cache line of keys
+#define KEYED_OFFSET (KEYED_ARITY - 1) // keys[-KEYED_OFFSET] is 64-byte aligned
+#define HEAP_BACKEND(q) ((q)->backend == PRIQUEUE_HEAP || (q)->backend == PRIQUEUE_KEYED)
+#define KEYED_KEY(q, ptr) ((long long)((q)->key(ptr) ^ (1ULL << 63)))
+
+/*
+  Node pool for PRIQUEUE_LIST, PRIQUEUE_RBTREE and for handles. Nodes are carved out of chunks that grow
+  geometrically and are only returned to the system by priqueue_destroy(),
+  so a queue that has reached its working size never touches malloc again.
+ */
+static node pool_alloc(priqueue_t *q)
+{
+	if (q->free_nodes == NULL)
+	{
+		q->chunk_nodes = q->chunk_nodes ? q->chunk_nodes * 2 : POOL_INITIAL_NODES;
+		if (q->chunk_nodes > POOL_MAX_CHUNK_NODES)
+			q->chunk_nodes = POOL_MAX_CHUNK_NODES;
+
+		node_chunk_t *chunk = malloc(sizeof(node_chunk_t) + q->chunk_nodes * sizeof(struct Node));
+		chunk->next = q->chunks;
+		q->chunks = chunk;
+
+		for (int i = 0; i < q->chunk_nodes; i++)
+		{
+			chunk->nodes[i].next = q->free_nodes;
+			q->free_nodes = &chunk->nodes[i];
+		}
+	}
+
+	node n = q->free_nodes;
+	q->free_nodes = n->next;
+	return n;
+}
+
+/*
+  Counts one insertion as a pool hit, or as a miss if it had to grow the
+  node pool or the heap. Each offer counts exactly once, including a heap
+  offer that also takes a handle node from the pool.
+ */
+static void pool_count(priqueue_t *q, int grows)
+{
+	if (grows)
+		q->pool_misses++;
+	else
+		q->pool_hits++;
+}
+
+static void pool_free(priqueue_t *q, node n)
+{
+	n->next = q->free_nodes;
+	q->free_nodes = n;
+}
+
+/*
+  Binary heap helpers for PRIQUEUE_HEAP. The generic sift routines call the
+  comparer through q->comp; queues created with priqueue_init_heap_ops()
+  use routines with their comparer compiled in.
+ */
+PRIQUEUE_HEAP_SPECIALIZE(generic, q->comp);
+
+static inline int heap_before(priqueue_t *q, heap_entry_t *a, heap_entry_t *b)
+{
+	return q->heap_ops->before(q, a, b);
+}
+
+static inline int heap_sift_up(priqueue_t *q, int i)
+{
+	return q->heap_ops->sift_up(q, i);
+}
+
+static inline int heap_sift_down(priqueue_t *q, int i)
+{
+	return q->heap_ops->sift_down(q, i);
+}
+
+static inline void heap_track(priqueue_t *q, int i)
+{
+	PRIQUEUE_HEAP_TRACK(q, i);
+}
+
+/* Moves the entry at from, and its key if the queue is keyed, to to. */
+static inline void heap_move(priqueue_t *q, int to, int from)
+{
+	q->heap[to] = q->heap[from];
+	if (q->keys != NULL)
+		q->keys[to] = q->keys[from];
+	heap_track(q, to);
+}
+
+/*
+  PRIQUEUE_KEYED: an 8-ary heap ordered by precomputed 64-bit keys (then
+  insertion sequence). The keys live in their own array with each node's
+  children in one aligned cache line, so sifting never touches the
+  elements themselves and the smallest child is found with one SIMD pass.
+  Keys are stored with the sign bit flipped so signed compares order them
+  as unsigned values.
+ */
+static inline int keyed_less(priqueue_t *q, long long key_a, unsigned long seq_a, int b)
+{
+	return key_a < q->keys[b] || (key_a == q->keys[b] && seq_a < q->heap[b].seq);
+}
+
+/* Only valid for entries stored in q->heap, which is how it is called. */
+static int keyed_before(priqueue_t *q, heap_entry_t *a, heap_entry_t *b)
+{
+	int i = a - q->heap;
+	return keyed_less(q, q->keys[i], a->seq, b - q->heap);
+}
+
+static int keyed_sift_up(priqueue_t *q, int i)
+{
+	heap_entry_t e = q->heap[i];
+	long long key = q->keys[i];
+	while (i > 0)
+	{
+		int parent = (i - 1) / KEYED_ARITY;
+		if (!keyed_less(q, key, e.seq, parent))
+			break;
+		heap_move(q, i, parent);
+		i = parent;
+	}
+	q->heap[i] = e;
+	q->keys[i] = key;
+	heap_track(q, i);
+	return i;
+}
+
+static inline int keyed_min_child(priqueue_t *q, int first, int count)
+{
+	int child = first;
+	for (int c = first + 1; c < first + count; c++)
+	{
+		if (keyed_less(q, q->keys[c], q->heap[c].seq, child))
+			child = c;
+	}
+	return child;
+}
+
+static inline __attribute__((always_inline)) int keyed_sift_down_impl(priqueue_t *q, int i, int (*min_child8)(priqueue_t*, int))
+{
+	heap_entry_t e = q->heap[i];
+	long long key = q->keys[i];
+	int first;
+	while ((first = KEYED_ARITY * i + 1) < q->size)
+	{
+		int child = first + KEYED_ARITY <= q->size ? min_child8(q, first) : keyed_min_child(q, first, q->size - first);
+		if (keyed_less(q, key, e.seq, child))
+			break;
+		heap_move(q, i, child);
+		i = child;
+	}
+	q->heap[i] = e;
+	q->keys[i] = key;
+	heap_track(q, i);
+	return i;
+}
+
+static int keyed_min_child8_scalar(priqueue_t *q, int first)
+{
+	return keyed_min_child(q, first, KEYED_ARITY);
+}
+
+static int keyed_sift_down_scalar(priqueue_t *q, int i)
+{
+	return keyed_sift_down_impl(q, i, keyed_min_child8_scalar);
+}
+
+static const priqueue_heap_ops_t keyed_scalar_heap_ops = { keyed_sift_up, keyed_sift_down_scalar, keyed_before };
+
+#ifdef KEYED_AVX2
+/*
+  Finds the smallest of the 8 keys starting at first (an aligned block):
+  a lane-wise min of both halves, reduced across lanes, then the lanes
+  holding it. Equal keys fall back to the insertion sequence.
+ */
+__attribute__((target("avx2")))
+static inline int keyed_min_child8_avx2(priqueue_t *q, int first)
+{
+	const long long *k = &q->keys[first];
+	__m256i lo = _mm256_load_si256((const __m256i *)k);
+	__m256i hi = _mm256_load_si256((const __m256i *)(k + 4));
+
+	__m256i m = _mm256_blendv_epi8(lo, hi, _mm256_cmpgt_epi64(lo, hi));
+	__m256i s = _mm256_permute4x64_epi64(m, _MM_SHUFFLE(1, 0, 3, 2));
+	m = _mm256_blendv_epi8(m, s, _mm256_cmpgt_epi64(m, s));
+	s = _mm256_permute4x64_epi64(m, _MM_SHUFFLE(2, 3, 0, 1));
+	m = _mm256_blendv_epi8(m, s, _mm256_cmpgt_epi64(m, s));
+
+	int mask = _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(lo, m))) |
+			_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(hi, m))) << 4;
+	int child = first + __builtin_ctz(mask);
+	for (mask &= mask - 1; mask != 0; mask &= mask - 1)
+	{
+		int c = first + __builtin_ctz(mask);
+		if (q->heap[c].seq < q->heap[child].seq)
+			child = c;
+	}
+	return child;
+}
+
+__attribute__((target("avx2")))
+static int keyed_sift_down_avx2(priqueue_t *q, int i)
+{
+	return keyed_sift_down_impl(q, i, keyed_min_child8_avx2);
+}
+
+static const priqueue_heap_ops_t keyed_avx2_heap_ops = { keyed_sift_up, keyed_sift_down_avx2, keyed_before };
+#endif
+
+/* Allocates a key array for capacity entries, aligned as KEYED_OFFSET describes. */
+static long long *keyed_alloc(int capacity)
+{
+	size_t bytes = (capacity + KEYED_OFFSET) * sizeof(long long);
+	long long *base = aligned_alloc(64, (bytes + 63) / 64 * 64);
+	return base + KEYED_OFFSET;
+}
+
+static void keyed_free(long long *keys)
+{
+	if (keys != NULL)
+		free(keys - KEYED_OFFSET);
+}
+
+static void keyed_grow(priqueue_t *q, int old_capacity)
+{
+	long long *keys = keyed_alloc(q->capacity);
+	if (q->keys != NULL)
+		memcpy(keys, q->keys, old_capacity * sizeof(long long));
+	keyed_free(q->keys);
+	keyed_free(q->keys_scratch);
+	q->keys = keys;
+	q->keys_scratch = keyed_alloc(q->capacity);
+}
+
+/*
+  Rearranges the heap into fully sorted order. A sorted array is still a
+  valid heap, so this only costs anything after the queue was modified and
+  makes priqueue_at()/priqueue_remove_at() index in priority order.
+ */
+static void heap_sort(priqueue_t *q)
+{
+	if (q->sorted)
+		return;
+
+	int n = q->size;
+	heap_entry_t *sorted = q->heap_scratch;
+	long long *sorted_keys = q->keys_scratch;
+	for (int i = 0; i < n; i++)
+	{
+		sorted[i] = q->heap[0];
+		if (sorted_keys != NULL)
+			sorted_keys[i] = q->keys[0];
+		heap_move(q, 0, --q->size);
+		if (q->size > 0)
+			heap_sift_down(q, 0);
+	}
+	q->heap_scratch = q->heap;
+	q->heap = sorted;
+	q->keys_scratch = q->keys;
+	q->keys = sorted_keys;
+	q->size = n;
+	q->sorted = 1;
+	for (int i = 0; i < n; i++)
+		heap_track(q, i);
+}
+
+static int heap_offer(priqueue_t *q, void *ptr, node handle)
+{
+	if (q->size == q->capacity)
+	{
+		int old_capacity = q->capacity;
+		q->capacity = q->capacity ? q->capacity * 2 : HEAP_INITIAL_CAPACITY;
+		q->heap = realloc(q->heap, q->capacity * sizeof(heap_entry_t));
+		q->heap_scratch = realloc(q->heap_scratch, q->capacity * sizeof(heap_entry_t));
+		if (q->backend == PRIQUEUE_KEYED)
+			keyed_grow(q, old_capacity);
+	}
+
+	int i = q->size++;
+	q->heap[i].process = ptr;
+	q->heap[i].seq = q->seq++;
+	q->heap[i].handle = handle;
+	if (q->keys != NULL)
+		q->keys[i] = KEYED_KEY(q, ptr);
+	int location = heap_sift_up(q, i);
+
+	/* Appending a new maximum is the only way a sorted heap stays sorted. */
+	if (q->sorted && i > 0 && (location != i || heap_before(q, &q->heap[i], &q->heap[i - 1])))
+		q->sorted = 0;
+
+	return location;
+}
+
+static void *heap_poll(priqueue_t *q)
+{
+	void *top = q->heap[0].process;
+	if (q->heap[0].handle != NULL)
+		pool_free(q, q->heap[0].handle);
+	q->size--;
+	if (q->size > 0)
+	{
+		heap_move(q, 0, q->size);
+		heap_sift_down(q, 0);
+		q->sorted = q->size == 1;
+	}
+	return top;
+}
+
+static int heap_remove(priqueue_t *q, void *ptr)
+{
+	int kept = 0;
+	for (int i = 0; i < q->size; i++)
+	{
+		if (q->heap[i].process != ptr)
+			heap_move(q, kept++, i);
+		else if (q->heap[i].handle != NULL)
+			pool_free(q, q->heap[i].handle);
+	}
+
+	int removed = q->size - kept;
+	q->size = kept;
+
+	/* Compaction preserves sorted order but not the heap shape. */
+	if (removed > 0 && !q->sorted)
+	{
+		for (int i = q->size / 2 - 1; i >= 0; i--)
+			heap_sift_down(q, i);
+	}
+	return removed;
+}
+
+static void *heap_remove_at(priqueue_t *q, int index)
+{
+	heap_sort(q);
+
+	void *process = q->heap[index].process;
+	if (q->heap[index].handle != NULL)
+		pool_free(q, q->heap[index].handle);
+	for (int i = index; i < q->size - 1; i++)
+		heap_move(q, i, i + 1);
+	q->size--;
+	return process;
+}
+
+/*
+  Takes the entry at i out of the heap by moving the last entry into its
+  place and restoring the heap property around it: O(log n).
+ */
+static void *heap_remove_entry(priqueue_t *q, int i)
+{
+	void *process = q->heap[i].process;
+	pool_free(q, q->heap[i].handle);
+
+	if (i != --q->size)
+	{
+		heap_move(q, i, q->size);
+		if (heap_sift_up(q, i) == i)
+			heap_sift_down(q, i);
+		q->sorted = q->size <= 1;
+	}
+	return process;
+}
+
+/*
+  Moves the entry at i to where its new key belongs. Like the list backend,
+  which re-inserts the element, it goes behind the elements it now ties with.
+ */
+static int heap_update_entry(priqueue_t *q, int i)
+{
+	q->heap[i].seq = q->seq++;
+	if (q->keys != NULL)
+		q->keys[i] = KEYED_KEY(q, q->heap[i].process);
+	int location = heap_sift_up(q, i);
+	if (location == i)
+		location = heap_sift_down(q, i);
+	q->sorted = q->size <= 1;
+	return location;
+}
+
+/*
+  Links n into the sorted list behind every element that is not after it,
+  so ties stay FIFO, and returns its index.
+ */
+static int list_insert(priqueue_t *q, node n)
+{
+	node temp = q->head, previous = NULL;
+	int location = 0;
+
+	while (temp != NULL && q->comp(temp->process, n->process) <= 0)
+	{
+		previous = temp;
+		temp = temp->next;
+		location++;
+	}
+
+	n->prev = previous;
+	n->next = temp;
+	if (previous == NULL)
+		q->head = n;
+	else
+		previous->next = n;
+	if (temp != NULL)
+		temp->prev = n;
+
+	q->size++;
+	return location;
+}
+
+static void list_unlink(priqueue_t *q, node n)
+{
+	if (n->prev == NULL)
+		q->head = n->next;
+	else
+		n->prev->next = n->next;
+	if (n->next != NULL)
+		n->next->prev = n->prev;
+	q->size--;
+}
+
+/*
+  PRIQUEUE_RBTREE: a red-black tree over the nodes of the sorted list, so
+  the insertion point is found in O(log n) while head stays the cached
+  leftmost node and the list still serves peek, poll and in-order walks.
+ */
+static void tree_rotate_left(priqueue_t *q, node x)
+{
+	node y = x->right;
+
+	x->right = y->left;
+	if (y->left != NULL)
+		y->left->parent = x;
+	y->parent = x->parent;
+	if (x->parent == NULL)
+		q->root = y;
+	else if (x == x->parent->left)
+		x->parent->left = y;
+	else
+		x->parent->right = y;
+	y->left = x;
+	x->parent = y;
+}
+
+static void tree_rotate_right(priqueue_t *q, node x)
+{
+	node y = x->left;
+
+	x->left = y->right;
+	if (y->right != NULL)
+		y->right->parent = x;
+	y->parent = x->parent;
+	if (x->parent == NULL)
+		q->root = y;
+	else if (x == x->parent->right)
+		x->parent->right = y;
+	else
+		x->parent->left = y;
+	y->right = x;
+	x->parent = y;
+}
+
+/*
+  Puts n behind every element that is not after it, like list_insert(),
+  and rebalances. Returns 0 if n became the head, 1 otherwise.
+ */
+static int tree_insert(priqueue_t *q, node n)
+{
+	node parent = NULL, previous = NULL, next = NULL, cur = q->root;
+
+	while (cur != NULL)
+	{
+		parent = cur;
+		if (q->comp(n->process, cur->process) < 0)
+		{
+			next = cur;
+			cur = cur->left;
+		}
+		else
+		{
+			previous = cur;
+			cur = cur->right;
+		}
+	}
+
+	n->left = n->right = NULL;
+	n->parent = parent;
+	n->red = 1;
+	if (parent == NULL)
+		q->root = n;
+	else if (parent == next)
+		parent->left = n;
+	else
+		parent->right = n;
+
+	n->prev = previous;
+	n->next = next;
+	if (previous == NULL)
+		q->head = n;
+	else
+		previous->next = n;
+	if (next != NULL)
+		next->prev = n;
+	q->size++;
+
+	node x = n;
+	while (x->parent != NULL && x->parent->red)
+	{
+		node p = x->parent, g = p->parent;
+		if (p == g->left)
+		{
+			node uncle = g->right;
+			if (uncle != NULL && uncle->red)
+			{
+				p->red = uncle->red = 0;
+				g->red = 1;
+				x = g;
+				continue;
+			}
+			if (x == p->right)
+			{
+				tree_rotate_left(q, p);
+				p = x;
+			}
+			p->red = 0;
+			g->red = 1;
+			tree_rotate_right(q, g);
+			break;
+		}
+		else
+		{
+			node uncle = g->left;
+			if (uncle != NULL && uncle->red)
+			{
+				p->red = uncle->red = 0;
+				g->red = 1;
+				x = g;
+				continue;
+			}
+			if (x == p->left)
+			{
+				tree_rotate_right(q, p);
+				p = x;
+			}
+			p->red = 0;
+			g->red = 1;
+			tree_rotate_left(q, g);
+			break;
+		}
+	}
+	q->root->red = 0;
+
+	return previous == NULL ? 0 : 1;
+}
+
+/* Puts subtree v where subtree u hangs. */
+static void tree_transplant(priqueue_t *q, node u, node v)
+{
+	if (u->parent == NULL)
+		q->root = v;
+	else if (u == u->parent->left)
+		u->parent->left = v;
+	else
+		u->parent->right = v;
+	if (v != NULL)
+		v->parent = u->parent;
+}
+
+/* Restores the black heights after a black node was taken out above x. */
+static void tree_erase_fixup(priqueue_t *q, node x, node parent)
+{
+	while (x != q->root && (x == NULL || !x->red))
+	{
+		if (x == parent->left)
+		{
+			node w = parent->right;
+			if (w->red)
+			{
+				w->red = 0;
+				parent->red = 1;
+				tree_rotate_left(q, parent);
+				w = parent->right;
+			}
+			if ((w->left == NULL || !w->left->red) && (w->right == NULL || !w->right->red))
+			{
+				w->red = 1;
+				x = parent;
+				parent = x->parent;
+				continue;
+			}
+			if (w->right == NULL || !w->right->red)
+			{
+				w->left->red = 0;
+				w->red = 1;
+				tree_rotate_right(q, w);
+				w = parent->right;
+			}
+			w->red = parent->red;
+			parent->red = 0;
+			w->right->red = 0;
+			tree_rotate_left(q, parent);
+		}
+		else
+		{
+			node w = parent->left;
+			if (w->red)
+			{
+				w->red = 0;
+				parent->red = 1;
+				tree_rotate_right(q, parent);
+				w = parent->left;
+			}
+			if ((w->left == NULL || !w->left->red) && (w->right == NULL || !w->right->red))
+			{
+				w->red = 1;
+				x = parent;
+				parent = x->parent;
+				continue;
+			}
+			if (w->left == NULL || !w->left->red)
+			{
+				w->right->red = 0;
+				w->red = 1;
+				tree_rotate_left(q, w);
+				w = parent->left;
+			}
+			w->red = parent->red;
+			parent->red = 0;
+			w->left->red = 0;
+			tree_rotate_right(q, parent);
+		}
+		x = q->root;
+	}
+	if (x != NULL)
+		x->red = 0;
+}
+
+static void tree_unlink(priqueue_t *q, node z)
+{
+	node x, parent;
+	int removed_red = z->red;
+
+	if (z->left == NULL)
+	{
+		x = z->right;
+		parent = z->parent;
+		tree_transplant(q, z, x);
+	}
+	else if (z->right == NULL)
+	{
+		x = z->left;
+		parent = z->parent;
+		tree_transplant(q, z, x);
+	}
+	else
+	{
+		/* With two subtrees the in-order successor is the list successor. */
+		node y = z->next;
+		removed_red = y->red;
+		x = y->right;
+		if (y->parent == z)
+			parent = y;
+		else
+		{
+			parent = y->parent;
+			tree_transplant(q, y, x);
+			y->right = z->right;
+			y->right->parent = y;
+		}
+		tree_transplant(q, z, y);
+		y->left = z->left;
+		y->left->parent = y;
+		y->red = z->red;
+	}
+
+	if (!removed_red)
+		tree_erase_fixup(q, x, parent);
+	list_unlink(q, z);
+}
+
+/* Links n in with the PRIQUEUE_LIST or PRIQUEUE_RBTREE structure. */
+static int node_insert(priqueue_t *q, node n)
+{
+	if (q->backend == PRIQUEUE_RBTREE)
+		return tree_insert(q, n);
+	return list_insert(q, n);
+}
+
+static void node_unlink(priqueue_t *q, node n)
+{
+	if (q->backend == PRIQUEUE_RBTREE)
+		tree_unlink(q, n);
+	else
+		list_unlink(q, n);
+}
+
+/**
+  Initializes the priqueue_t data structure.
+
+  Assumtions
+    - You may assume this function will only be called once per instance of priqueue_t
+    - You may assume this function will be the first function called using an instance of priqueue_t.
+  @param q a pointer to an instance of the priqueue_t data structure
+  @param comparer a function pointer that compares two elements.
+  See also @ref comparer-page
+ */
+void priqueue_init(priqueue_t *q, int(*comparer)(const void *, const void *))
+{
+	priqueue_init_backend(q, comparer, PRIQUEUE_LIST);
+}
+
+
+/**
+  Initializes the priqueue_t data structure with an explicit storage backend.
+
+  PRIQUEUE_LIST keeps a sorted linked list (O(n) offer, O(1) poll).
+  PRIQUEUE_HEAP keeps an array-backed binary heap (O(log n) offer and poll).
+  PRIQUEUE_RBTREE threads the sorted list through a red-black tree (O(log n)
+  offer and poll, O(1) peek); offer returns 0 when the element became the
+  head and 1 otherwise instead of its index.
+  All three break comparer ties in insertion (FIFO) order.
+  PRIQUEUE_KEYED queues are created with priqueue_init_keyed() instead.
+
+  @param q a pointer to an instance of the priqueue_t data structure
+  @param comparer a function pointer that compares two elements.
+  @param backend the storage strategy used by q
+ */
+void priqueue_init_backend(priqueue_t *q, int(*comparer)(const void *, const void *), priqueue_backend_t backend)
+{
+	q->comp = comparer;
+	q->size = 0;
+	q->head = NULL;
+	q->root = NULL;
+	q->backend = backend;
+	q->heap_ops = &generic_heap_ops;
+	q->key = NULL;
+	q->keys = NULL;
+	q->keys_scratch = NULL;
+	q->heap = NULL;
+	q->heap_scratch = NULL;
+	q->capacity = 0;
+	q->seq = 0;
+	q->sorted = 1;
+	q->free_nodes = NULL;
+	q->chunks = NULL;
+	q->chunk_nodes = 0;
+	q->pool_hits = 0;
+	q->pool_misses = 0;
+}
+
+
+/**
+  Initializes q as a PRIQUEUE_HEAP queue whose heap routines are ops,
+  typically generated by PRIQUEUE_HEAP_SPECIALIZE() for comparer so each
+  comparison is inlined rather than made through a function pointer.
+
+  @param q a pointer to an instance of the priqueue_t data structure
+  @param comparer a function pointer that compares two elements, ordering them like ops
+  @param ops the heap routines used by q
+ */
+void priqueue_init_heap_ops(priqueue_t *q, int(*comparer)(const void *, const void *), const priqueue_heap_ops_t *ops)
+{
+	priqueue_init_backend(q, comparer, PRIQUEUE_HEAP);
+	q->heap_ops = ops;
+}
+
+
+/**
+  Initializes q as a PRIQUEUE_KEYED queue. Elements are ordered by the
+  64-bit key computed once when they are offered (or updated), smallest
+  first, with equal keys in insertion (FIFO) order. Pack the fields the
+  order depends on into the key, most significant first.
+
+  PRIQUEUE_KEYED is an 8-ary heap that keeps the keys in a separate
+  array, so ordering decisions never dereference elements; on CPUs with
+  AVX2 the smallest of a node's children is found with vector compares.
+
+  @param q a pointer to an instance of the priqueue_t data structure
+  @param key a function pointer that computes the sort key of an element
+ */
+void priqueue_init_keyed(priqueue_t *q, priqueue_key_t key)
+{
+	priqueue_init_backend(q, NULL, PRIQUEUE_KEYED);
+	q->key = key;
+	q->heap_ops = &keyed_scalar_heap_ops;
+#ifdef KEYED_AVX2
+	if (__builtin_cpu_supports("avx2"))
+		q->heap_ops = &keyed_avx2_heap_ops;
+#endif
+}
+
+
+/**
+  Inserts the specified element into this priority queue.
+
+  @param q a pointer to an instance of the priqueue_t data structure
+  @param ptr a pointer to the data to be inserted into the priority queue
+  @return The zero-based index where ptr is stored in the priority queue,
+	where 0 indicates that ptr was stored at the front of the priority queue.
+ */
+int priqueue_offer(priqueue_t *q, void *ptr)
+{
+	if (HEAP_BACKEND(q))
+	{
+		pool_count(q, q->size == q->capacity);
+		return heap_offer(q, ptr, NULL);
+	}
+
+	pool_count(q, q->free_nodes == NULL);
+	node n_node = pool_alloc(q);
+	n_node->process = ptr;
+	return node_insert(q, n_node);
+}
+
+
+/**
+  Inserts the specified element like priqueue_offer() and hands back a
+  reference to it, so it can later be removed with priqueue_remove_handle()
+  or repositioned with priqueue_update_key() without searching the queue.
+
+  @param q a pointer to an instance of the priqueue_t data structure
+  @param ptr a pointer to the data to be inserted into the priority queue
+  @param handle receives the reference to the inserted element
+  @return The zero-based index where ptr is stored in the priority queue,
+	as returned by priqueue_offer().
+ */
+int priqueue_offer_handle(priqueue_t *q, void *ptr, priqueue_handle_t *handle)
+{
+	pool_count(q, q->free_nodes == NULL || (HEAP_BACKEND(q) && q->size == q->capacity));
+	node n_node = pool_alloc(q);
+	n_node->process = ptr;
+	*handle = n_node;
+
+	if (HEAP_BACKEND(q))
+		return heap_offer(q, ptr, n_node);
+	return node_insert(q, n_node);
+}
+
+
+/**
+  Retrieves, but does not remove, the head of this queue, returning NULL if
+  this queue is empty.
+
+  @param q a pointer to an instance of the priqueue_t data structure
+  @return pointer to element at the head of the queue
+  @return NULL if the queue is empty
+ */
+void *priqueue_peek(priqueue_t *q)
+{
+	if(q->size == 0)
+	{
+		return NULL;
+	}
+	else if (HEAP_BACKEND(q))
+	{
+		return q->heap[0].process;
+	}
+	else
+	{
+		return q->head->process;
+	}
+}
+
+
+/**
+  Retrieves and removes the head of this queue, or NULL if this queue
+  is empty.
+
+  @param q a pointer to an instance of the priqueue_t data structure
+  @return the head of this queue
+  @return NULL if this queue is empty
+ */
+void *priqueue_poll(priqueue_t *q)
+{
+	if(q->size == 0)
+	{
+		return NULL;
+	}
+	if (HEAP_BACKEND(q))
+		return heap_poll(q);
+
+	node temp = q->head;
+	void* return_process = temp->process;
+
+	node_unlink(q, temp);
+	pool_free(q, temp);
+	return return_process;
+}
+
+
+/**
+  Returns the element at the specified position in this list, or NULL if
+  the queue does not contain an index'th element.
+
+  With PRIQUEUE_HEAP the heap is brought into sorted order first, so
+  iterating over every index costs O(n log n) once rather than per call.
+
+  @param q a pointer to an instance of the priqueue_t data structure
+  @param index position of retrieved element
+  @return the index'th element in the queue
+  @return NULL if the queue does not contain the index'th element
+ */
+void *priqueue_at(priqueue_t *q, int index)
+{
+	if(index < 0 || index >= q->size)
+	{
+		return NULL;
+	}
+	else if (HEAP_BACKEND(q))
+	{
+		heap_sort(q);
+		return q->heap[index].process;
+	}
+	else
+	{
+		node temp = q->head;
+		int tracker = 1;
+		while(tracker <= index)
+		{
+			temp = temp->next;
+			tracker++;
+		}
+		return temp->process;
+	}
+}
+
+
+/**
+  Removes all instances of ptr from the queue.
+
+  This function should not use the comparer function,
+	but check if the data contained in each element of the queue is equal (==) to ptr.
+
+  @param q a pointer to an instance of the priqueue_t data structure
+  @param ptr address of element to be removed
+  @return the number of entries removed
+ */
+int priqueue_remove(priqueue_t *q, void *ptr)
+{
+	if (HEAP_BACKEND(q))
+		return heap_remove(q, ptr);
+
+	int num_deleted = 0;
+	node current = q->head, temp;
+
+	while (current != NULL) {
+		if(current->process == ptr){
+			num_deleted++;
+			temp = current->next;
+			node_unlink(q, current);
+			pool_free(q, current);
+			current = temp;
+			}
+		else{
+			current = current->next;
+		}
+	}
+	return num_deleted;
+}
+
+
+
+/**
+  Removes the specified index from the queue, moving later elements up
+  a spot in the queue to fill the gap.
+
+  @param q a pointer to an instance of the priqueue_t data structure
+  @param index position of element to be removed
+  @return the element removed from the queue
+  @return NULL if the specified index does not exist
+ */
+void *priqueue_remove_at(priqueue_t *q, int index)
+{
+	if(index < 0 || index >= q->size)
+	{
+		return NULL;
+	}
+	if (HEAP_BACKEND(q))
+		return heap_remove_at(q, index);
+
+	node delEle = q->head;
+	int tracker = 0;
+	while(tracker < index)
+	{
+		delEle = delEle->next;
+		tracker++;
+	}
+	node_unlink(q, delEle);
+
+	void* process_deleted = delEle->process;
+	pool_free(q, delEle);
+	return process_deleted;
+}
+
+
+/**
+  Removes the element behind handle from the queue: O(1) with
+  PRIQUEUE_LIST and O(log n) with PRIQUEUE_HEAP and PRIQUEUE_RBTREE. handle
+  is invalid afterwards.
+
+  @param q a pointer to an instance of the priqueue_t data structure
+  @param handle reference returned by priqueue_offer_handle() for an element still in q
+  @return the element removed from the queue
+ */
+void *priqueue_remove_handle(priqueue_t *q, priqueue_handle_t handle)
+{
+	if (HEAP_BACKEND(q))
+		return heap_remove_entry(q, handle->index);
+
+	void* process_deleted = handle->process;
+	node_unlink(q, handle);
+	pool_free(q, handle);
+	return process_deleted;
+}
+
+
+/**
+  Repositions the element behind handle after the fields the comparer
+  looks at changed (e.g. a decreased key). The element is placed as if it
+  had just been offered, behind any elements it now ties with. O(log n)
+  with PRIQUEUE_HEAP and PRIQUEUE_RBTREE; PRIQUEUE_LIST has to walk to the
+  new position.
+
+  @param q a pointer to an instance of the priqueue_t data structure
+  @param handle reference returned by priqueue_offer_handle() for an element still in q
+  @return the zero-based index where the element is now stored, as
+	returned by priqueue_offer()
+ */
+int priqueue_update_key(priqueue_t *q, priqueue_handle_t handle)
+{
+	if (HEAP_BACKEND(q))
+		return heap_update_entry(q, handle->index);
+
+	node_unlink(q, handle);
+	return node_insert(q, handle);
+}
+
+
+/**
+  Returns the number of elements in the queue.
+
+  @param q a pointer to an instance of the priqueue_t data structure
+  @return the number of elements in the queue
+ */
+int priqueue_size(priqueue_t *q)
+{
+	return q->size;
+}
+
+
+/**
+  Reports how often q satisfied an insertion from memory it already owned
+  (hits) versus how often it had to grow its node pool or heap (misses).
+
+  @param q a pointer to an instance of the priqueue_t data structure
+  @param hits if not NULL, receives the number of pool hits
+  @param misses if not NULL, receives the number of pool misses
+ */
+void priqueue_pool_stats(priqueue_t *q, unsigned long *hits, unsigned long *misses)
+{
+	if (hits != NULL)
+		*hits = q->pool_hits;
+	if (misses != NULL)
+		*misses = q->pool_misses;
+}
+
+
+/**
+  Destroys and frees all the memory associated with q.
+
+  @param q a pointer to an instance of the priqueue_t data structure
+ */
+void priqueue_destroy(priqueue_t *q)
+{
+	node_chunk_t *chunk = q->chunks, *next;
+	while(chunk != NULL)
+	{
+		next = chunk->next;
+		free(chunk);
+		chunk = next;
+	}
+	free(q->heap);
+	free(q->heap_scratch);
+	keyed_free(q->keys);
+	keyed_free(q->keys_scratch);
+
+	q->head = NULL;
+	q->root = NULL;
+	q->free_nodes = NULL;
+	q->chunks = NULL;
+	q->chunk_nodes = 0;
+	q->heap = NULL;
+	q->heap_scratch = NULL;
+	q->keys = NULL;
+	q->keys_scratch = NULL;
+	q->capacity = 0;
+	q->size = 0;
+}
@@ -1,39 +1,117 @@
-/** @file libpriqueue.h
- */
-
-#ifndef LIBPRIQUEUE_H_
-#define LIBPRIQUEUE_H_
-
-struct Node;
-/**
-  Priqueue Data Structure
-*/
-typedef struct Node
-{
-  struct Node *next;
-  void* process;
-} *node;
-
-node current, previous, temp;
-
-typedef struct _priqueue_t
-{
-  int size;
-  node head;
-  int(*comp)(const void*, const void*);
-} priqueue_t;
-
-
-void   priqueue_init     (priqueue_t *q, int(*comparer)(const void*, const void*));
-
-int   priqueue_offer    (priqueue_t *q, void *ptr);
-void* priqueue_peek     (priqueue_t *q);
-void* priqueue_poll     (priqueue_t *q);
-void* priqueue_at       (priqueue_t *q, int index);
-int   priqueue_remove   (priqueue_t *q, void *ptr);
-void* priqueue_remove_at(priqueue_t *q, int index);
-int   priqueue_size     (priqueue_t *q);
-
-void  priqueue_destroy  (priqueue_t *q);
-
-#endif /* LIBPQUEUE_H_ */
+/** @file libpriqueue.h
+ */
+
+#ifndef LIBPRIQUEUE_H_
+#define LIBPRIQUEUE_H_
+
+struct Node;
+/**
+  Priqueue Data Structure
+*/
+typedef struct Node
+{
+  struct Node *next;
+  struct Node *prev;
+  void* process;
+  int index; // PRIQUEUE_HEAP: where the element sits in the heap
+  int red; // PRIQUEUE_RBTREE: node color
+  struct Node *left; // PRIQUEUE_RBTREE: subtrees and parent; next/prev keep the in-order list
+  struct Node *right;
+  struct Node *parent;
+} *node;
+
+/**
+  Opaque reference to an element offered with priqueue_offer_handle(). It
+  stays valid until the element leaves the queue (poll, any remove, destroy).
+*/
+typedef struct Node *priqueue_handle_t;
+
+/**
+  Block of list nodes carved up by the per-queue node pool.
+*/
+typedef struct _node_chunk_t
+{
+  struct _node_chunk_t *next;
+  struct Node nodes[];
+} node_chunk_t;
+
+/**
+  Entry of the array-backed binary heap. seq records insertion order so
+  elements the comparer considers equal are polled first-in first-out.
+*/
+typedef struct _heap_entry_t
+{
+  void* process;
+  unsigned long seq;
+  node handle; // NULL unless offered through priqueue_offer_handle()
+} heap_entry_t;
+
+struct _priqueue_t;
+/**
+  Heap routines of a priqueue_t. The defaults call the comparer through
+  its pointer; PRIQUEUE_HEAP_SPECIALIZE() in libpriqueue_heap.h generates
+  versions with the comparer inlined.
+*/
+typedef struct _priqueue_heap_ops_t
+{
+  int (*sift_up)(struct _priqueue_t *q, int i);
+  int (*sift_down)(struct _priqueue_t *q, int i);
+  int (*before)(struct _priqueue_t *q, heap_entry_t *a, heap_entry_t *b);
+} priqueue_heap_ops_t;
+
+/**
+  Storage strategies selectable behind the priqueue_t API.
+*/
+typedef enum {PRIQUEUE_LIST = 0, PRIQUEUE_HEAP, PRIQUEUE_KEYED, PRIQUEUE_RBTREE} priqueue_backend_t;
+
+/**
+  Sort key of an element for PRIQUEUE_KEYED: smaller keys are polled first.
+*/
+typedef unsigned long long (*priqueue_key_t)(const void*);
+
+typedef struct _priqueue_t
+{
+  int size;
+  node head;
+  node root; // PRIQUEUE_RBTREE: tree over the same nodes as the list at head
+  int(*comp)(const void*, const void*);
+
+  priqueue_backend_t backend;
+  const priqueue_heap_ops_t* heap_ops;
+  priqueue_key_t key;
+  long long* keys; // PRIQUEUE_KEYED: sort keys in step with heap, sign bit flipped
+  long long* keys_scratch;
+  heap_entry_t* heap;
+  heap_entry_t* heap_scratch;
+  int capacity;
+  unsigned long seq;
+  int sorted;
+
+  node free_nodes;
+  node_chunk_t* chunks;
+  int chunk_nodes;
+  unsigned long pool_hits;
+  unsigned long pool_misses;
+} priqueue_t;
+
+
+void   priqueue_init     (priqueue_t *q, int(*comparer)(const void*, const void*));
+void   priqueue_init_backend(priqueue_t *q, int(*comparer)(const void*, const void*), priqueue_backend_t backend);
+void   priqueue_init_heap_ops(priqueue_t *q, int(*comparer)(const void*, const void*), const priqueue_heap_ops_t *ops);
+void   priqueue_init_keyed(priqueue_t *q, priqueue_key_t key);
+
+int   priqueue_offer    (priqueue_t *q, void *ptr);
+int   priqueue_offer_handle(priqueue_t *q, void *ptr, priqueue_handle_t *handle);
+void* priqueue_peek     (priqueue_t *q);
+void* priqueue_poll     (priqueue_t *q);
+void* priqueue_at       (priqueue_t *q, int index);
+int   priqueue_remove   (priqueue_t *q, void *ptr);
+void* priqueue_remove_at(priqueue_t *q, int index);
+void* priqueue_remove_handle(priqueue_t *q, priqueue_handle_t handle);
+int   priqueue_update_key(priqueue_t *q, priqueue_handle_t handle);
+int   priqueue_size     (priqueue_t *q);
+void  priqueue_pool_stats(priqueue_t *q, unsigned long *hits, unsigned long *misses);
+
+void  priqueue_destroy  (priqueue_t *q);
+
+#endif /* LIBPQUEUE_H_ */
@@ -0,0 +1,84 @@
+/** @file libpriqueue_heap.h
+ */
+
+#ifndef LIBPRIQUEUE_HEAP_H_
+#define LIBPRIQUEUE_HEAP_H_
+
+#include "libpriqueue.h"
+
+/**
+  Defines sift routines for the PRIQUEUE_HEAP backend with a fixed
+  comparer, plus a priqueue_heap_ops_t named name##_heap_ops that
+  priqueue_init_heap_ops() accepts.
+
+  compare is called directly instead of through the pointer stored in
+  priqueue_t, so the compiler can inline it into the sift loops. Give it
+  a static function (or an expression usable as compare(a, b) inside a
+  function with q in scope) that orders elements exactly like the
+  comparer passed to priqueue_init_heap_ops().
+
+  Entries are ordered by compare and then by insertion sequence, which
+  makes the heap a total order and keeps ties first-in first-out like the
+  list backend.
+*/
+#define PRIQUEUE_HEAP_SPECIALIZE(name, compare) \
+	static int name##_heap_before(priqueue_t *q, heap_entry_t *a, heap_entry_t *b) \
+	{ \
+		(void)q; /* only for compare expressions that use it */ \
+		int c = compare(a->process, b->process); \
+		if (c != 0) \
+			return c < 0; \
+		return a->seq < b->seq; \
+	} \
+	\
+	static int name##_heap_sift_up(priqueue_t *q, int i) \
+	{ \
+		heap_entry_t e = q->heap[i]; \
+		while (i > 0) \
+		{ \
+			int parent = (i - 1) / 2; \
+			if (!name##_heap_before(q, &e, &q->heap[parent])) \
+				break; \
+			q->heap[i] = q->heap[parent]; \
+			PRIQUEUE_HEAP_TRACK(q, i); \
+			i = parent; \
+		} \
+		q->heap[i] = e; \
+		PRIQUEUE_HEAP_TRACK(q, i); \
+		return i; \
+	} \
+	\
+	static int name##_heap_sift_down(priqueue_t *q, int i) \
+	{ \
+		heap_entry_t e = q->heap[i]; \
+		int child; \
+		while ((child = 2 * i + 1) < q->size) \
+		{ \
+			if (child + 1 < q->size && name##_heap_before(q, &q->heap[child + 1], &q->heap[child])) \
+				child++; \
+			if (!name##_heap_before(q, &q->heap[child], &e)) \
+				break; \
+			q->heap[i] = q->heap[child]; \
+			PRIQUEUE_HEAP_TRACK(q, i); \
+			i = child; \
+		} \
+		q->heap[i] = e; \
+		PRIQUEUE_HEAP_TRACK(q, i); \
+		return i; \
+	} \
+	\
+	static const priqueue_heap_ops_t name##_heap_ops = \
+	{ \
+		name##_heap_sift_up, \
+		name##_heap_sift_down, \
+		name##_heap_before, \
+	}
+
+/* Tells the handle of the entry now at i, if it has one, where it went. */
+#define PRIQUEUE_HEAP_TRACK(q, i) \
+	do { \
+		if ((q)->heap[i].handle != NULL) \
+			(q)->heap[i].handle->index = (i); \
+	} while (0)
+
+#endif /* LIBPRIQUEUE_HEAP_H_ */
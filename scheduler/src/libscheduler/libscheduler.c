@@ -1,318 +1,1836 @@
-/** @file libscheduler.c
- */
-
-#include <stdio.h>
-#include <stdlib.h>
-#include <string.h>
-
-#include "libscheduler.h"
-#include "../libpriqueue/libpriqueue.h"
-
-/**
-  Stores information making up a job to be scheduled including any statistics.
-
-  You may need to define some global variables or a struct to store your job queue elements.
-*/
-
-priqueue_t* q;
-int num_cores;
-float waiting_time;
-float turnaround_time;
-float response_time; //
-int num_jobs;
-int curr_time;
-scheme_t s;
-
-//array of cores
-job_t* cores_arr;
-
-
-int comparer(const void* a, const void* b)
-{
-	job_t job_a = (job_t) a;
-	job_t job_b = (job_t) b;
-
-	//compare differences
-	int priority_difference = job_a->priority - job_b ->priority;
-	int arrival_difference = job_a->arrival_time - job_b->arrival_time;
-	int run_differnce = job_a ->running_time - job_b->running_time;
-	int remaining_difference = job_a ->remaining_time - job_b->remaining_time;
-
-	//fcfs compare
-	if(s == FCFS)
-	{
-		return arrival_difference;
-	}
-	//ppri compare
-	if(s == PPRI)
-	{
-		if(priority_difference == 0)
-		{
-			return arrival_difference;
-		}
-    else
-		  return priority_difference;
-	}
-	//pri compare
-	if(s == PRI)
-	{
-		if(priority_difference == 0)
-		{
-			return arrival_difference;
-		}
-    else
-		  return priority_difference;
-	}
-	//psjf compare
-	if(s == PSJF)
-	{
-		if(remaining_difference == 0)
-		{
-			return arrival_difference;
-		}
-    else
-		  return remaining_difference;
-	}
-	//RR, nothing to compare
-	if(s == RR)
-	{
-		return 0;
-	}
-	//sjf compare
-	if(s == SJF)
-	{
-		if(run_differnce == 0)
-		{
-			return arrival_difference;
-		}
-    else
-		  return run_differnce;
-	}
-	//default
-  else
-	 return 0;
-}
-/**
-  Initalizes the scheduler.
-
-  Assumptions:
-    - You may assume this will be the first scheduler function called.
-    - You may assume this function will be called once once.
-    - You may assume that cores is a positive, non-zero number.
-    - You may assume that scheme is a valid scheduling scheme.
-
-  @param cores the number of cores that is available by the scheduler. These cores will be known as core(id=0), core(id=1), ..., core(id=cores-1).
-  @param scheme  the scheduling scheme that should be used. This value will be one of the six enum values of scheme_t
-*/
-void scheduler_start_up(int cores, scheme_t scheme)
-{
-	num_cores = cores;
-	waiting_time = 0.0;
-	turnaround_time = 0.0;
-	response_time = 0.0;
-	num_jobs = 0;
-	curr_time = 0;
-	s = scheme;
-  //cores array
-  cores_arr = (job_t*)malloc(sizeof(job_t) * num_cores);
-	for(int i = 0; i < cores; i++)
-	{
-		cores_arr[i] = NULL;
-	}
-  //jobs array
-	q = (priqueue_t*)malloc(sizeof(priqueue_t));
-	priqueue_init(q, &comparer);
-}
-
-
-/**
-  Called when a new job arrives.
-
-  If multiple cores are idle, the job should be assigned to the core with the
-  lowest id.
-  If the job arriving should be scheduled to run during the next
-  time cycle, return the zero-based index of the core the job should be
-  scheduled on. If another job is already running on the core specified,
-  this will preempt the currently running job.
-  Assumptions:
-    - You may assume that every job wil have a unique arrival time.
-
-  @param job_number a globally unique identification number of the job arriving.
-  @param time the current time of the simulator.
-  @param running_time the total number of time units this job will run before it will be finished.
-  @param priority the priority of the job. (The lower the value, the higher the priority.)
-  @return index of core job should be scheduled on
-  @return -1 if no scheduling changes should be made.
-
- */
-int scheduler_new_job(int job_number, int time, int running_time, int priority)
-{
-  for(int i = 0; i < num_jobs; i++){
-    job_t n_job = cores_arr[i];
-    //if remaining_time means the response time??
-    if (n_job != NULL && n_job->arrival_time != curr_time){
-      n_job->remaining_time = n_job->running_time - (curr_time - n_job->start_time);
-    }
-  }
-
-  int core_num = 0;
-  //job_t n_job = new_job(job_number, time, running_time, priority);
-
-  // give cores numbers
-  while(cores_arr[core_num] != NULL){
-    core_num++;
-  }
-
-//  if (core_num >= num_jobs)
-  return 0;
-}
-
-
-/**
-  Called when a job has completed execution.
-  The core_id, job_number and time parameters are provided for convenience. You may be able to calculate the values with your own data structure.
-  If any job should be scheduled to run on the core free'd up by the
-  finished job, return the job_number of the job that should be scheduled to
-  run on core core_id.
-
-  @param core_id the zero-based index of the core where the job was located.
-  @param job_number a globally unique identification number of the job.
-  @param time the current time of the simulator.
-  @return job_number of the job that should be scheduled to run on core core_id
-  @return -1 if core should remain idle.
- */
-int scheduler_job_finished(int core_id, int job_number, int time)
-{
-
-	return -1;
-}
-
-
-/**
-  When the scheme is set to RR, called when the quantum timer has expired
-  on a core.
-
-  If any job should be scheduled to run on the core free'd up by
-  the quantum expiration, return the job_number of the job that should be
-  scheduled to run on core core_id.
-
-  @param core_id the zero-based index of the core where the quantum has expired.
-  @param time the current time of the simulator.
-  @return job_number of the job that should be scheduled on core cord_id
-  @return -1 if core should remain idle
- */
-int scheduler_quantum_expired(int core_id, int time)
-{
-  job_t job_in_a_core = cores_arr[core_id];
-  if (job_in_a_core != NULL){
-    priqueue_offer(q, job_in_a_core);
-  }
-  else{
-    if(priqueue_size(q) == 0)
-      return -1;
-  }
-  // if running time means the process time for the job.
-  cores_arr[core_id] = priqueue_poll(q);
-  if(cores_arr[core_id]->running_time == -1){
-    cores_arr[core_id]-> running_time = time - cores_arr[core_id]->arrival_time;
-  }
-	return cores_arr[core_id]->id;
-}
-
-
-/**
-  Returns the average waiting time of all jobs scheduled by your scheduler.
-
-  Assumptions:
-    - This function will only be called after all scheduling is complete (all jobs that have arrived will have finished and no new jobs will arrive).
-  @return the average waiting time of all jobs scheduled.
- */
-float scheduler_average_waiting_time()
-{
-	if(num_jobs > 0)
-	{
-		return waiting_time/num_jobs;
-	}
-  else
-	  return 0.0;
-}
-
-
-/**
-  Returns the average turnaround time of all jobs scheduled by your scheduler.
-
-  Assumptions:
-    - This function will only be called after all scheduling is complete (all jobs that have arrived will have finished and no new jobs will arrive).
-  @return the average turnaround time of all jobs scheduled.
- */
-float scheduler_average_turnaround_time()
-{
-	if(num_jobs > 0)
-	{
-		return turnaround_time / num_jobs;
-	}
-  else
-	   return 0.0;
-}
-
-
-/**
-  Returns the average response time of all jobs scheduled by your scheduler.
-
-  Assumptions:
-    - This function will only be called after all scheduling is complete (all jobs that have arrived will have finished and no new jobs will arrive).
-  @return the average response time of all jobs scheduled.
- */
-float scheduler_average_response_time()
-{
-  if (num_jobs > 0)
-	  return response_time / num_jobs;
-  else
-    return 0.0;
-}
-
-
-/**
-  Free any memory associated with your scheduler.
-
-  Assumptions:
-    - This function will be the last function called in your library.
-*/
-void scheduler_clean_up()
-{
-  for(int i = 0; i< num_cores; i++){
-    if(cores_arr[i] != NULL){
-      free(cores_arr[i]);
-    }
-  }
-  free(cores_arr);
-}
-
-
-/**
-  This function may print out any debugging information you choose. This
-  function will be called by the simulator after every call the simulator
-  makes to your scheduler.
-  In our provided output, we have implemented this function to list the jobs in the order they are to be scheduled. Furthermore, we have also listed the current state of the job (either running on a given core or idle). For example, if we have a non-preemptive algorithm and job(id=4) has began running, job(id=2) arrives with a higher priority, and job(id=1) arrives with a lower priority, the output in our sample output will be:
-
-    2(-1) 4(0) 1(-1)
-
-  This function is not required and will not be graded. You may leave it
-  blank if you do not find it useful.
- */
-void scheduler_show_queue()
-{
-  for(int i = 0; i < q->size; i++){
-    if (i < num_jobs){
-      job_t n_job = cores_arr[i];
-
-      if( n_job == NULL){
-        printf("%d(%d) ", ((job_t) priqueue_at(q, i))->id, ((job_t) priqueue_at(q, i))->priority);
-      }
-      else{
-        printf("%d(%d) ", n_job->id, n_job->priority);
-      }
-    }
-  }
-	//Fill in if you want I wont be
-}
+/** @file libscheduler.c
+ */
+
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "libscheduler.h"
+#include "../libpriqueue/libpriqueue.h"
+#include "../libpriqueue/libpriqueue_heap.h"
+#include "../libhistogram/libhistogram.h"
+
+/**
+  A running job as seen by preemption: ordered so the job a new arrival
+  would displace first (the one the comparer puts last) is at the top.
+*/
+typedef struct _victim_t
+{
+  long long key; // PSJF: when the job would finish; PPRI: its priority (aged: times the period, at dispatch); MLFQ: its level; EDF: its deadline
+  int arrival_time;
+  int core_id;
+  priqueue_handle_t handle;
+} victim_t;
+
+/**
+  MLFQ run queue: a FIFO of job ids per level, linked through the job
+  table, and a bitmap of the levels that hold jobs so the highest
+  non-empty level is found with one bit scan.
+*/
+typedef struct _mlfq_queue_t
+{
+  int head[MLFQ_MAX_LEVELS];
+  int tail[MLFQ_MAX_LEVELS];
+  unsigned int nonempty; //bit l set while level l has jobs
+  int size;
+} mlfq_queue_t;
+
+/**
+  Latency histograms of the finished jobs of one priority.
+*/
+typedef struct _priority_class_t
+{
+  int priority;
+  histogram_t latency[LATENCY_METRICS];
+} priority_class_t;
+
+/**
+  Stores information making up a job to be scheduled including any statistics.
+
+  Everything a scheduler needs lives in its context, so independent
+  contexts can run side by side (e.g. one per thread).
+*/
+struct _scheduler_ctx_t
+{
+  priqueue_t* q;
+  int(*comp)(const void*, const void*);
+  int num_cores;
+  float waiting_time;
+  float turnaround_time;
+  float response_time;
+  int num_jobs;
+  int curr_time;
+  scheme_t s;
+
+  //array of cores
+  job_t* cores_arr;
+  int* dispatched_at; //when each core's job was put on it
+  unsigned long long* idle_cores; //bitmap, bit set while the core has no job
+
+  //running jobs by preemption order, NULL unless the scheme preempts
+  priqueue_t* victims;
+  victim_t* victim_slots;
+
+  //every job seen so far, indexed by job id
+  job_table_t jobs;
+
+  //per-core run queues, NULL when every core shares q
+  steal_policy_t steal_policy;
+  priqueue_t* run_queues;
+  core_stats_t* core_stats;
+  double* queue_length_area;
+  double imbalance_area;
+  int max_imbalance;
+  int last_event_time;
+
+  //MLFQ levels, one set per run queue; NULL for the other schemes
+  mlfq_config_t mlfq;
+  mlfq_queue_t* mlfq_queues;
+  int next_boost;
+
+  //CFS timing, total weight of runnable jobs and where new jobs start
+  //(one min_vruntime for every core, raised only by dispatch())
+  cfs_config_t cfs;
+  long long cfs_load;
+  long long min_vruntime;
+
+  //lateness of finished jobs that had a deadline: how late (0 if on time), or how early
+  histogram_t lateness;
+  histogram_t earliness;
+  int deadline_misses;
+  long long total_tardiness;
+
+  //PRI/PPRI: time units of waiting that earn one priority level, 0 if priorities are fixed
+  int aging_period;
+  int max_waiting_time;
+
+  //latency of finished jobs, overall and per priority (sorted by priority)
+  histogram_t latency[LATENCY_METRICS];
+  priority_class_t* classes;
+  int num_classes;
+
+  //per-core time spent running jobs and jobs completed, up to end_time
+  long long* busy_time;
+  int* jobs_finished;
+  int end_time;
+};
+
+//context behind the scheduler_* functions used by the simulator
+static scheduler_ctx_t* default_ctx;
+static steal_policy_t default_steal_policy;
+static mlfq_config_t default_mlfq;
+static cfs_config_t default_cfs;
+static int default_aging_period;
+
+#define IDLE_WORDS(cores) (((cores) + 63) / 64)
+
+#define JOB_CHUNK(ctx, id) ((ctx)->jobs.chunks[(id) >> JOB_CHUNK_BITS])
+#define JOB_COLD(ctx, field, job) (JOB_CHUNK(ctx, (job)->id)->field[(job)->id & JOB_CHUNK_MASK])
+#define JOB_OF(ctx, id) (&JOB_CHUNK(ctx, id)->hot[(id) & JOB_CHUNK_MASK])
+//hot is the first member of a chunk, so comparers reach cold fields without a context
+#define JOB_CHUNK_OF(job) ((job_chunk_t*)((job) - ((job)->id & JOB_CHUNK_MASK)))
+#define JOB_FIELD(field, job) (JOB_CHUNK_OF(job)->field[(job)->id & JOB_CHUNK_MASK])
+
+//EDF: a job without a deadline is due after every job with one
+#define JOB_DUE(job) (JOB_FIELD(deadline, job) < 0 ? INT_MAX : JOB_FIELD(deadline, job))
+
+/*
+ * Aging: a job that has waited w time units since it last arrived or
+ * was taken off a core ranks as priority - w / aging_period. Every queued
+ * job gains at the same rate, so their order never changes and the key
+ * priority * aging_period + (time it started waiting) ranks them exactly
+ * without revisiting the queue as time passes.
+ */
+#define AGING_KEY(ctx, job, time) ((long long)(job)->priority * (ctx)->aging_period + (time))
+
+/*
+ * CFS weight of each nice value from -20 to 19, as in Linux: one step is
+ * about a 25% larger or smaller share of the processor.
+ */
+static const int cfs_weights[40] =
+{
+  88761, 71755, 56483, 46273, 36291,
+  29154, 23254, 18705, 14949, 11916,
+   9548,  7620,  6100,  4904,  3906,
+   3121,  2501,  1991,  1586,  1277,
+   1024,   820,   655,   526,   423,
+    335,   272,   215,   172,   137,
+    110,    87,    70,    56,    45,
+     36,    29,    23,    18,    15,
+};
+
+#define CFS_NICE_0_WEIGHT 1024
+
+
+/**
+  Returns the CFS weight of job, treating its priority as a nice value.
+ */
+static int cfs_weight(job_t job)
+{
+  int nice = job->priority < -20 ? -20 : job->priority > 19 ? 19 : job->priority;
+  return cfs_weights[nice + 20];
+}
+
+
+/**
+  Frees chunk if it holds no unfinished job. The newest chunk is kept
+  even when empty, so a stream that finishes each job before the next
+  arrives does not allocate and free it for every job.
+ */
+static void job_table_drop(job_table_t *jobs, int chunk)
+{
+  if (jobs->chunks[chunk] != NULL && jobs->chunks[chunk]->live == 0 && chunk != jobs->newest)
+  {
+    free(jobs->chunks[chunk]);
+    jobs->chunks[chunk] = NULL;
+  }
+}
+
+
+/**
+  Returns the slot for job_number in the job table, allocating the chunk
+  that holds it the first time an id in that range is seen.
+ */
+static job_t job_table_add(scheduler_ctx_t *ctx, int job_number, int arr_time, int run_time, int priority, int deadline)
+{
+  job_table_t *jobs = &ctx->jobs;
+  int chunk = job_number >> JOB_CHUNK_BITS;
+  if (chunk >= jobs->num_chunks)
+  {
+    int n = jobs->num_chunks ? jobs->num_chunks : 1;
+    while (n <= chunk)
+      n *= 2;
+    jobs->chunks = realloc(jobs->chunks, n * sizeof(job_chunk_t*));
+    memset(jobs->chunks + jobs->num_chunks, 0, (n - jobs->num_chunks) * sizeof(job_chunk_t*));
+    jobs->num_chunks = n;
+  }
+  if (jobs->chunks[chunk] == NULL)
+  {
+    jobs->chunks[chunk] = malloc(sizeof(job_chunk_t));
+    jobs->chunks[chunk]->live = 0;
+  }
+  jobs->chunks[chunk]->live++;
+  if (chunk != jobs->newest)
+  {
+    int previous = jobs->newest;
+    jobs->newest = chunk;
+    job_table_drop(jobs, previous);
+  }
+
+  job_t job = &jobs->chunks[chunk]->hot[job_number & JOB_CHUNK_MASK];
+  job->id = job_number;
+  job->priority = priority;
+  job->arrival_time = arr_time;
+  job->running_time = run_time;
+  job->remaining_time = run_time;
+  JOB_COLD(ctx, start_time, job) = -1;
+  JOB_COLD(ctx, level, job) = 0;
+  JOB_COLD(ctx, quantum_left, job) = ctx->mlfq.quantum[0];
+  JOB_COLD(ctx, next, job) = -1;
+  JOB_COLD(ctx, vruntime, job) = ctx->min_vruntime;
+  JOB_COLD(ctx, deadline, job) = deadline;
+  JOB_COLD(ctx, aging_key, job) = AGING_KEY(ctx, job, arr_time);
+
+  return job;
+}
+
+
+/**
+  Puts job on core_id at time and records its first run for response time.
+ */
+static void dispatch(scheduler_ctx_t *ctx, int core_id, job_t job, int time)
+{
+  ctx->cores_arr[core_id] = job;
+  ctx->dispatched_at[core_id] = time;
+  ctx->idle_cores[core_id / 64] &= ~(1ULL << (core_id % 64));
+  if (JOB_COLD(ctx, start_time, job) == -1)
+    JOB_COLD(ctx, start_time, job) = time;
+
+  if (ctx->s == CFS){
+    // the job came off the front of a run queue, so nothing queued has run less
+    if (JOB_COLD(ctx, vruntime, job) > ctx->min_vruntime)
+      ctx->min_vruntime = JOB_COLD(ctx, vruntime, job);
+
+    // its weighted share of the latency period on each core
+    long long slice = (long long)ctx->cfs.target_latency * cfs_weight(job) * ctx->num_cores / ctx->cfs_load;
+    if (slice > ctx->cfs.target_latency)
+      slice = ctx->cfs.target_latency;
+    if (slice < ctx->cfs.min_granularity)
+      slice = ctx->cfs.min_granularity;
+    JOB_COLD(ctx, quantum_left, job) = slice;
+  }
+
+  if (ctx->victims != NULL){
+    // remaining_time + dispatched_at does not change while the job runs
+    victim_t *v = &ctx->victim_slots[core_id];
+    v->key = ctx->s == PSJF ? job->remaining_time + time :
+             ctx->s == MLFQ ? JOB_COLD(ctx, level, job) :
+             ctx->s == EDF ? JOB_DUE(job) :
+             ctx->aging_period > 0 ? JOB_COLD(ctx, aging_key, job) - time : job->priority;
+    v->arrival_time = job->arrival_time;
+    priqueue_offer_handle(ctx->victims, v, &v->handle);
+  }
+}
+
+
+/**
+  Marks core_id idle.
+ */
+static void release(scheduler_ctx_t *ctx, int core_id)
+{
+  ctx->cores_arr[core_id] = NULL;
+  ctx->idle_cores[core_id / 64] |= 1ULL << (core_id % 64);
+  if (ctx->victims != NULL)
+    priqueue_remove_handle(ctx->victims, ctx->victim_slots[core_id].handle);
+}
+
+
+/**
+  Returns the idle core with the lowest id, or -1 if every core is busy.
+ */
+static int first_idle_core(scheduler_ctx_t *ctx)
+{
+  for(int i = 0; i < IDLE_WORDS(ctx->num_cores); i++){
+    if (ctx->idle_cores[i] != 0)
+      return i * 64 + __builtin_ctzll(ctx->idle_cores[i]);
+  }
+  return -1;
+}
+
+
+/**
+  Takes the job off core_id at time, charging it for the time it ran.
+  A job dispatched and preempted in the same time unit never ran, so it
+  has not responded yet either.
+ */
+static job_t undispatch(scheduler_ctx_t *ctx, int core_id, int time)
+{
+  job_t job = ctx->cores_arr[core_id];
+  int ran = time - ctx->dispatched_at[core_id];
+
+  // negative while the core is still switching to the job: give back the unpaid overhead
+  ctx->busy_time[core_id] += ran;
+  if (ran < 0)
+    ran = 0;
+  job->remaining_time -= ran;
+  JOB_COLD(ctx, quantum_left, job) -= ran;
+  if (ctx->s == CFS)
+    JOB_COLD(ctx, vruntime, job) += (long long)ran * CFS_NICE_0_WEIGHT * CFS_NICE_0_WEIGHT / cfs_weight(job);
+  if (ran == 0 && JOB_COLD(ctx, start_time, job) == time)
+    JOB_COLD(ctx, start_time, job) = -1;
+  // a running job does not age; it starts waiting again from now
+  if (ctx->aging_period > 0)
+    JOB_COLD(ctx, aging_key, job) = AGING_KEY(ctx, job, time);
+
+  release(ctx, core_id);
+  return job;
+}
+
+
+/**
+  Returns the run queue core_id pulls from.
+ */
+static priqueue_t* queue_of(scheduler_ctx_t *ctx, int core_id)
+{
+  return ctx->run_queues ? &ctx->run_queues[core_id] : ctx->q;
+}
+
+
+/**
+  Returns the MLFQ levels core_id pulls from.
+ */
+static mlfq_queue_t* mlfq_of(scheduler_ctx_t *ctx, int core_id)
+{
+  return &ctx->mlfq_queues[ctx->run_queues ? core_id : 0];
+}
+
+
+/**
+  Appends job to the queue of the level it is at.
+ */
+static void mlfq_push(scheduler_ctx_t *ctx, mlfq_queue_t *mq, job_t job)
+{
+  int level = JOB_COLD(ctx, level, job);
+
+  JOB_COLD(ctx, next, job) = -1;
+  if (mq->head[level] == -1)
+    mq->head[level] = job->id;
+  else
+    JOB_COLD(ctx, next, JOB_OF(ctx, mq->tail[level])) = job->id;
+  mq->tail[level] = job->id;
+  mq->nonempty |= 1u << level;
+  mq->size++;
+}
+
+
+/**
+  Takes the first job of the highest non-empty level. A job found on a
+  higher level than it was queued at was boosted, and starts a fresh slice.
+ */
+static job_t mlfq_pop(scheduler_ctx_t *ctx, mlfq_queue_t *mq)
+{
+  if (mq->nonempty == 0)
+    return NULL;
+
+  int level = __builtin_ctz(mq->nonempty);
+  job_t job = JOB_OF(ctx, mq->head[level]);
+
+  mq->head[level] = JOB_COLD(ctx, next, job);
+  if (mq->head[level] == -1)
+  {
+    mq->tail[level] = -1;
+    mq->nonempty &= ~(1u << level);
+  }
+  mq->size--;
+
+  if (JOB_COLD(ctx, level, job) != level)
+  {
+    JOB_COLD(ctx, level, job) = level;
+    JOB_COLD(ctx, quantum_left, job) = ctx->mlfq.quantum[level];
+  }
+  return job;
+}
+
+
+/**
+  Moves every queued job back to level 0, keeping higher levels first and
+  each level's order, by splicing the level lists: O(levels).
+ */
+static void mlfq_boost(scheduler_ctx_t *ctx, mlfq_queue_t *mq)
+{
+  for(int level = 1; level < ctx->mlfq.levels; level++){
+    if (mq->head[level] == -1)
+      continue;
+
+    if (mq->head[0] == -1)
+      mq->head[0] = mq->head[level];
+    else
+      JOB_COLD(ctx, next, JOB_OF(ctx, mq->tail[0])) = mq->head[level];
+    mq->tail[0] = mq->tail[level];
+    mq->head[level] = mq->tail[level] = -1;
+  }
+  mq->nonempty = mq->size > 0 ? 1u : 0u;
+}
+
+
+/**
+  Applies the periodic MLFQ boost if a boost time has passed since the
+  previous scheduler event. Queues only change at events, so boosting at
+  the first event after the boost time is the same as boosting on time.
+ */
+static void check_boost(scheduler_ctx_t *ctx, int time)
+{
+  if (ctx->mlfq_queues == NULL || ctx->mlfq.boost_period <= 0 || time < ctx->next_boost)
+    return;
+
+  for(int i = 0; i < (ctx->run_queues ? ctx->num_cores : 1); i++){
+    mlfq_boost(ctx, &ctx->mlfq_queues[i]);
+  }
+  ctx->next_boost = time - time % ctx->mlfq.boost_period + ctx->mlfq.boost_period;
+}
+
+
+/**
+  Returns the number of jobs waiting in core_id's run queue.
+ */
+static int queue_length(scheduler_ctx_t *ctx, int core_id)
+{
+  if (ctx->mlfq_queues != NULL)
+    return mlfq_of(ctx, core_id)->size;
+  return priqueue_size(queue_of(ctx, core_id));
+}
+
+
+/**
+  Takes the first job off core_id's run queue, NULL if it is empty.
+ */
+static job_t queue_poll(scheduler_ctx_t *ctx, int core_id)
+{
+  if (ctx->mlfq_queues != NULL)
+    return mlfq_pop(ctx, mlfq_of(ctx, core_id));
+  return priqueue_poll(queue_of(ctx, core_id));
+}
+
+
+/**
+  Charges the run queue lengths and the spread between the longest and
+  shortest queue for the time since the previous scheduler event.
+ */
+static void account_queues(scheduler_ctx_t *ctx, int time)
+{
+  int dt = time - ctx->last_event_time;
+  if (ctx->run_queues == NULL || dt <= 0)
+    return;
+
+  int shortest = queue_length(ctx, 0);
+  int longest = shortest;
+  for(int i = 0; i < ctx->num_cores; i++){
+    int length = queue_length(ctx, i);
+    ctx->queue_length_area[i] += (double)length * dt;
+    if (length < shortest)
+      shortest = length;
+    if (length > longest)
+      longest = length;
+  }
+
+  ctx->imbalance_area += (double)(longest - shortest) * dt;
+  if (longest - shortest > ctx->max_imbalance)
+    ctx->max_imbalance = longest - shortest;
+  ctx->last_event_time = time;
+}
+
+
+/**
+  Queues job on core_id's run queue.
+ */
+static void enqueue(scheduler_ctx_t *ctx, int core_id, job_t job)
+{
+  if (ctx->mlfq_queues != NULL)
+    mlfq_push(ctx, mlfq_of(ctx, core_id), job);
+  else
+    priqueue_offer(queue_of(ctx, core_id), job);
+
+  int length = queue_length(ctx, core_id);
+  if (ctx->run_queues && length > ctx->core_stats[core_id].max_queue_length)
+    ctx->core_stats[core_id].max_queue_length = length;
+}
+
+
+/**
+  Moves work from the longest peer run queue to core_id's, one job or
+  half of the peer's queue depending on the steal policy. Jobs are taken
+  from the front of the peer's queue, so the best candidates move first.
+
+  @return the number of jobs moved
+ */
+static int steal(scheduler_ctx_t *ctx, int core_id)
+{
+  int peer = -1;
+  for(int i = 0; i < ctx->num_cores; i++){
+    if (i != core_id && queue_length(ctx, i) > 0 &&
+        (peer == -1 || queue_length(ctx, i) > queue_length(ctx, peer)))
+      peer = i;
+  }
+  if (peer == -1)
+    return 0;
+
+  int count = 1;
+  if (ctx->steal_policy == STEAL_HALF)
+    count = (queue_length(ctx, peer) + 1) / 2;
+
+  for(int i = 0; i < count; i++){
+    enqueue(ctx, core_id, queue_poll(ctx, peer));
+  }
+  ctx->core_stats[core_id].steals++;
+  ctx->core_stats[core_id].stolen_jobs += count;
+  return count;
+}
+
+
+/**
+  Takes the next job for core_id off its run queue, stealing from a peer
+  when the local queue is empty.
+ */
+static job_t next_job(scheduler_ctx_t *ctx, int core_id)
+{
+  job_t job = queue_poll(ctx, core_id);
+  if (job == NULL && ctx->run_queues && steal(ctx, core_id) > 0)
+    job = queue_poll(ctx, core_id);
+  return job;
+}
+
+
+/*
+ * One comparer per scheme. The priority queue calls them without a
+ * context, so the scheme is picked once when the context is created
+ * instead of being looked up on every comparison.
+ */
+static int compare_fcfs(const void* a, const void* b)
+{
+	return ((job_t) a)->arrival_time - ((job_t) b)->arrival_time;
+}
+
+static int compare_sjf(const void* a, const void* b)
+{
+	job_t job_a = (job_t) a;
+	job_t job_b = (job_t) b;
+
+	if (job_a->running_time == job_b->running_time)
+		return job_a->arrival_time - job_b->arrival_time;
+	return job_a->running_time - job_b->running_time;
+}
+
+static int compare_psjf(const void* a, const void* b)
+{
+	job_t job_a = (job_t) a;
+	job_t job_b = (job_t) b;
+
+	if (job_a->remaining_time == job_b->remaining_time)
+		return job_a->arrival_time - job_b->arrival_time;
+	return job_a->remaining_time - job_b->remaining_time;
+}
+
+static int compare_priority(const void* a, const void* b)
+{
+	job_t job_a = (job_t) a;
+	job_t job_b = (job_t) b;
+
+	if (job_a->priority == job_b->priority)
+		return job_a->arrival_time - job_b->arrival_time;
+	return job_a->priority - job_b->priority;
+}
+
+//RR, nothing to compare
+static int compare_rr(const void* a, const void* b)
+{
+	return 0;
+}
+
+static int compare_cfs(const void* a, const void* b)
+{
+	long long vruntime_a = JOB_FIELD(vruntime, (job_t) a);
+	long long vruntime_b = JOB_FIELD(vruntime, (job_t) b);
+
+	if (vruntime_a == vruntime_b)
+		return 0;
+	return vruntime_a < vruntime_b ? -1 : 1;
+}
+
+static int compare_aging(const void* a, const void* b)
+{
+	long long key_a = JOB_FIELD(aging_key, (job_t) a);
+	long long key_b = JOB_FIELD(aging_key, (job_t) b);
+
+	if (key_a == key_b)
+		return ((job_t) a)->arrival_time - ((job_t) b)->arrival_time;
+	return key_a < key_b ? -1 : 1;
+}
+
+static int compare_edf(const void* a, const void* b)
+{
+	int due_a = JOB_DUE((job_t) a);
+	int due_b = JOB_DUE((job_t) b);
+
+	if (due_a == due_b)
+		return ((job_t) a)->arrival_time - ((job_t) b)->arrival_time;
+	return due_a < due_b ? -1 : 1;
+}
+
+/*
+ * Orders victim_t: latest finish (or worst priority) first, then latest
+ * arrival, then lowest core id, matching a scan for the job the scheme's
+ * comparer puts last.
+ */
+static int compare_victim(const void* a, const void* b)
+{
+	const victim_t *v_a = a, *v_b = b;
+
+	if (v_a->key != v_b->key)
+		return v_a->key > v_b->key ? -1 : 1;
+	if (v_a->arrival_time != v_b->arrival_time)
+		return v_a->arrival_time > v_b->arrival_time ? -1 : 1;
+	return v_a->core_id - v_b->core_id;
+}
+
+/*
+ * Heap routines with each comparer compiled in, so the run queues do not
+ * make an indirect call per comparison. PRI and PPRI order jobs alike.
+ */
+PRIQUEUE_HEAP_SPECIALIZE(fcfs, compare_fcfs);
+PRIQUEUE_HEAP_SPECIALIZE(sjf, compare_sjf);
+PRIQUEUE_HEAP_SPECIALIZE(psjf, compare_psjf);
+PRIQUEUE_HEAP_SPECIALIZE(priority, compare_priority);
+PRIQUEUE_HEAP_SPECIALIZE(aging, compare_aging);
+PRIQUEUE_HEAP_SPECIALIZE(rr, compare_rr);
+PRIQUEUE_HEAP_SPECIALIZE(edf, compare_edf);
+PRIQUEUE_HEAP_SPECIALIZE(victim, compare_victim);
+
+static int (*const scheme_comparer[])(const void*, const void*) =
+{
+	[FCFS] = compare_fcfs,
+	[SJF] = compare_sjf,
+	[PSJF] = compare_psjf,
+	[PRI] = compare_priority,
+	[PPRI] = compare_priority,
+	[RR] = compare_rr,
+	[MLFQ] = compare_rr,
+	[CFS] = compare_cfs,
+	[EDF] = compare_edf,
+};
+
+/*
+ * The same orders as packed sort keys: the primary field in the high half
+ * and arrival time in the low half, each with its sign bit flipped so
+ * negative values still sort first.
+ */
+#define KEY_FIELD(v) ((unsigned long long)((unsigned int)(v) ^ 0x80000000u))
+#define KEY_PACK(high, low) (KEY_FIELD(high) << 32 | KEY_FIELD(low))
+
+static unsigned long long key_fcfs(const void* a)
+{
+	return KEY_PACK(0, ((job_t) a)->arrival_time);
+}
+
+static unsigned long long key_sjf(const void* a)
+{
+	return KEY_PACK(((job_t) a)->running_time, ((job_t) a)->arrival_time);
+}
+
+static unsigned long long key_psjf(const void* a)
+{
+	return KEY_PACK(((job_t) a)->remaining_time, ((job_t) a)->arrival_time);
+}
+
+static unsigned long long key_priority(const void* a)
+{
+	return KEY_PACK(((job_t) a)->priority, ((job_t) a)->arrival_time);
+}
+
+static unsigned long long key_edf(const void* a)
+{
+	return KEY_PACK(JOB_DUE((job_t) a), ((job_t) a)->arrival_time);
+}
+
+/*
+ * Schemes with a sort key use PRIQUEUE_KEYED run queues. RR jobs all tie,
+ * which the keyed heap can only settle by insertion order one child at a
+ * time, so RR keeps the binary heap.
+ */
+static const priqueue_key_t scheme_key[] =
+{
+	[FCFS] = key_fcfs,
+	[SJF] = key_sjf,
+	[PSJF] = key_psjf,
+	[PRI] = key_priority,
+	[PPRI] = key_priority,
+	[RR] = NULL,
+	[MLFQ] = NULL,
+	[CFS] = NULL,
+	[EDF] = key_edf,
+};
+
+static const priqueue_heap_ops_t *const scheme_heap_ops[] =
+{
+	[FCFS] = &fcfs_heap_ops,
+	[SJF] = &sjf_heap_ops,
+	[PSJF] = &psjf_heap_ops,
+	[PRI] = &priority_heap_ops,
+	[PPRI] = &priority_heap_ops,
+	[RR] = &rr_heap_ops,
+	[MLFQ] = &rr_heap_ops,
+	[CFS] = NULL,
+	[EDF] = &edf_heap_ops,
+};
+
+
+/**
+  Sets up a run queue ordered for scheme. CFS keeps its jobs in a
+  red-black tree by virtual runtime, with the leftmost node cached.
+ */
+static void init_run_queue(priqueue_t *q, scheme_t scheme)
+{
+  if (scheme == CFS)
+    priqueue_init_backend(q, scheme_comparer[scheme], PRIQUEUE_RBTREE);
+  else if (scheme_key[scheme] != NULL)
+    priqueue_init_keyed(q, scheme_key[scheme]);
+  else
+    priqueue_init_heap_ops(q, scheme_comparer[scheme], scheme_heap_ops[scheme]);
+}
+
+
+/**
+  Creates an independent scheduler. Contexts share no state, so separate
+  contexts may be used from separate threads without locking.
+
+  @param cores the number of cores that is available by the scheduler. These cores will be known as core(id=0), core(id=1), ..., core(id=cores-1).
+  @param scheme  the scheduling scheme that should be used. This value will be one of the enum values of scheme_t
+  @param steal STEAL_NONE for a single shared run queue, STEAL_ONE or STEAL_HALF for per-core run queues
+  @return the new context, to be released with scheduler_destroy()
+ */
+scheduler_ctx_t* scheduler_create(int cores, scheme_t scheme, steal_policy_t steal)
+{
+  scheduler_ctx_t* ctx = calloc(1, sizeof(scheduler_ctx_t));
+
+	ctx->num_cores = cores;
+	ctx->s = scheme;
+	ctx->comp = scheme_comparer[scheme];
+	ctx->steal_policy = steal;
+  //cores array
+  ctx->cores_arr = (job_t*)calloc(cores, sizeof(job_t));
+  ctx->dispatched_at = (int*)calloc(cores, sizeof(int));
+  ctx->busy_time = (long long*)calloc(cores, sizeof(long long));
+  ctx->jobs_finished = (int*)calloc(cores, sizeof(int));
+  for(int i = 0; i < LATENCY_METRICS; i++)
+    histogram_init(&ctx->latency[i]);
+  histogram_init(&ctx->lateness);
+  histogram_init(&ctx->earliness);
+  ctx->idle_cores = (unsigned long long*)calloc(IDLE_WORDS(cores), sizeof(unsigned long long));
+  for(int i = 0; i < cores; i++)
+    ctx->idle_cores[i / 64] |= 1ULL << (i % 64);
+
+  if (scheme == PSJF || scheme == PPRI || scheme == MLFQ || scheme == EDF)
+  {
+    ctx->victims = (priqueue_t*)malloc(sizeof(priqueue_t));
+    ctx->victim_slots = (victim_t*)calloc(cores, sizeof(victim_t));
+    for(int i = 0; i < cores; i++)
+      ctx->victim_slots[i].core_id = i;
+    priqueue_init_heap_ops(ctx->victims, compare_victim, &victim_heap_ops);
+  }
+  //jobs array
+	ctx->q = (priqueue_t*)malloc(sizeof(priqueue_t));
+	init_run_queue(ctx->q, scheme);
+
+  //per-core run queues
+  if (steal != STEAL_NONE)
+  {
+    ctx->run_queues = (priqueue_t*)malloc(sizeof(priqueue_t) * cores);
+    ctx->core_stats = (core_stats_t*)calloc(cores, sizeof(core_stats_t));
+    ctx->queue_length_area = (double*)calloc(cores, sizeof(double));
+    for(int i = 0; i < cores; i++)
+    {
+      init_run_queue(&ctx->run_queues[i], scheme);
+    }
+  }
+
+  //MLFQ levels, replaced by scheduler_ctx_set_mlfq()
+  if (scheme == MLFQ)
+  {
+    mlfq_config_t config = MLFQ_DEFAULT_CONFIG;
+    ctx->mlfq_queues = (mlfq_queue_t*)malloc(sizeof(mlfq_queue_t) * (steal != STEAL_NONE ? cores : 1));
+    scheduler_ctx_set_mlfq(ctx, &config);
+  }
+
+  //CFS timing, replaced by scheduler_ctx_set_cfs()
+  if (scheme == CFS)
+  {
+    cfs_config_t config = CFS_DEFAULT_CONFIG;
+    scheduler_ctx_set_cfs(ctx, &config);
+  }
+
+  return ctx;
+}
+
+
+/*
+ * Returns whether n_job, arriving at time, should take the core of the
+ * running job victim. MLFQ arrivals start at level 0 and so beat any job
+ * that was demoted. An aging job stops aging while it runs, so it is held
+ * to the priority it had reached when it was dispatched, which its victim
+ * key records; an arrival has not waited and ranks at its own priority.
+ */
+static int preempts(scheduler_ctx_t *ctx, job_t n_job, int victim, int time)
+{
+  if (ctx->s == MLFQ)
+    return JOB_COLD(ctx, level, ctx->cores_arr[victim]) > 0;
+  if (ctx->aging_period > 0)
+    return JOB_COLD(ctx, aging_key, n_job) - time < ctx->victim_slots[victim].key;
+  return ctx->comp(n_job, ctx->cores_arr[victim]) < 0;
+}
+
+
+/**
+  Called when a new job arrives.
+
+  If multiple cores are idle, the job should be assigned to the core with the
+  lowest id.
+  If the job arriving should be scheduled to run during the next
+  time cycle, return the zero-based index of the core the job should be
+  scheduled on. If another job is already running on the core specified,
+  this will preempt the currently running job.
+
+  @param ctx the scheduler
+  @param job_number a globally unique identification number of the job arriving.
+  @param time the current time of the simulator.
+  @param running_time the total number of time units this job will run before it will be finished.
+  @param priority the priority of the job. (The lower the value, the higher the priority.)
+  @return index of core job should be scheduled on
+  @return -1 if no scheduling changes should be made.
+ */
+int scheduler_ctx_new_job(scheduler_ctx_t *ctx, int job_number, int time, int running_time, int priority)
+{
+  return scheduler_ctx_new_job_deadline(ctx, job_number, time, running_time, priority, -1);
+}
+
+
+/**
+  Called when a new job with a deadline arrives; otherwise the same as
+  scheduler_ctx_new_job(). EDF runs the job with the earliest deadline,
+  and every scheme reports how jobs fared against their deadlines through
+  scheduler_ctx_deadline_stats().
+
+  @param ctx the scheduler
+  @param job_number a globally unique identification number of the job arriving.
+  @param time the current time of the simulator.
+  @param running_time the total number of time units this job will run before it will be finished.
+  @param priority the priority of the job. (The lower the value, the higher the priority.)
+  @param deadline the time the job should finish by, -1 if it has none
+  @return index of core job should be scheduled on
+  @return -1 if no scheduling changes should be made.
+ */
+int scheduler_ctx_new_job_deadline(scheduler_ctx_t *ctx, int job_number, int time, int running_time, int priority, int deadline)
+{
+  job_t n_job = job_table_add(ctx, job_number, time, running_time, priority, deadline);
+  job_t* cores_arr = ctx->cores_arr;
+  if (ctx->s == CFS)
+    ctx->cfs_load += cfs_weight(n_job);
+  ctx->curr_time = time;
+  account_queues(ctx, time);
+  check_boost(ctx, time);
+
+  // give the job to the idle core with the lowest id
+  int idle = first_idle_core(ctx);
+  if (idle != -1){
+    dispatch(ctx, idle, n_job, time);
+    return idle;
+  }
+
+  if (ctx->victims != NULL){
+    // preempt the running job that would be scheduled last, if the new one beats it
+    int victim = ((victim_t*)priqueue_peek(ctx->victims))->core_id;
+    job_t v_job = cores_arr[victim];
+
+    // running jobs' remaining time is only brought up to date when compared
+    int ran = time - ctx->dispatched_at[victim];
+    if (ran > 0){
+      v_job->remaining_time -= ran;
+      JOB_COLD(ctx, quantum_left, v_job) -= ran;
+      ctx->busy_time[victim] += ran;
+      ctx->dispatched_at[victim] = time;
+    }
+
+    if (preempts(ctx, n_job, victim, time)){
+      enqueue(ctx, victim, undispatch(ctx, victim, time));
+      dispatch(ctx, victim, n_job, time);
+      return victim;
+    }
+  }
+
+  // every core is busy: queue the job on the shortest run queue
+  int target = 0;
+  for(int i = 1; ctx->run_queues && i < ctx->num_cores; i++){
+    if (queue_length(ctx, i) < queue_length(ctx, target))
+      target = i;
+  }
+  enqueue(ctx, target, n_job);
+  return -1;
+}
+
+
+/**
+  Returns the latency histograms of priority, adding an empty class in
+  priority order the first time a job of that priority finishes. Past
+  LATENCY_MAX_CLASSES - 1 classes, new priorities share the last one.
+ */
+static priority_class_t* priority_class(scheduler_ctx_t *ctx, int priority)
+{
+  int low = 0, high = ctx->num_classes;
+  while (low < high){
+    int mid = (low + high) / 2;
+    if (ctx->classes[mid].priority < priority)
+      low = mid + 1;
+    else
+      high = mid;
+  }
+  if (low < ctx->num_classes && ctx->classes[low].priority == priority)
+    return &ctx->classes[low];
+  if (ctx->num_classes >= LATENCY_MAX_CLASSES - 1 && priority != LATENCY_OTHER_PRIORITIES)
+    return priority_class(ctx, LATENCY_OTHER_PRIORITIES);
+
+  ctx->classes = realloc(ctx->classes, (ctx->num_classes + 1) * sizeof(priority_class_t));
+  memmove(&ctx->classes[low + 1], &ctx->classes[low], (ctx->num_classes - low) * sizeof(priority_class_t));
+  ctx->num_classes++;
+  ctx->classes[low].priority = priority;
+  for(int i = 0; i < LATENCY_METRICS; i++)
+    histogram_init(&ctx->classes[low].latency[i]);
+  return &ctx->classes[low];
+}
+
+
+/**
+  Adds the waiting, response and turnaround times of job, which finished
+  at time, to the overall and per-priority histograms.
+ */
+static void record_latency(scheduler_ctx_t *ctx, job_t job, int time)
+{
+  int latency[LATENCY_METRICS];
+  latency[LATENCY_WAITING] = time - job->arrival_time - job->running_time;
+  latency[LATENCY_RESPONSE] = JOB_COLD(ctx, start_time, job) - job->arrival_time;
+  latency[LATENCY_TURNAROUND] = time - job->arrival_time;
+
+  priority_class_t *class = priority_class(ctx, job->priority);
+  for(int i = 0; i < LATENCY_METRICS; i++){
+    histogram_record(&ctx->latency[i], latency[i]);
+    histogram_record(&class->latency[i], latency[i]);
+  }
+}
+
+
+/**
+  Called when a job has completed execution.
+  If any job should be scheduled to run on the core free'd up by the
+  finished job, return the job_number of the job that should be scheduled to
+  run on core core_id.
+
+  @param ctx the scheduler
+  @param core_id the zero-based index of the core where the job was located.
+  @param job_number a globally unique identification number of the job.
+  @param time the current time of the simulator.
+  @return job_number of the job that should be scheduled to run on core core_id
+  @return -1 if core should remain idle.
+ */
+int scheduler_ctx_job_finished(scheduler_ctx_t *ctx, int core_id, int job_number, int time)
+{
+  job_t f_job = ctx->cores_arr[core_id];
+  account_queues(ctx, time);
+  check_boost(ctx, time);
+
+  ctx->num_jobs++;
+  if (ctx->s == CFS)
+    ctx->cfs_load -= cfs_weight(f_job);
+  ctx->turnaround_time += time - f_job->arrival_time;
+  ctx->waiting_time += time - f_job->arrival_time - f_job->running_time;
+  if (time - f_job->arrival_time - f_job->running_time > ctx->max_waiting_time)
+    ctx->max_waiting_time = time - f_job->arrival_time - f_job->running_time;
+  record_latency(ctx, f_job, time);
+
+  ctx->busy_time[core_id] += time - ctx->dispatched_at[core_id];
+  ctx->jobs_finished[core_id]++;
+  if (time > ctx->end_time)
+    ctx->end_time = time;
+  ctx->response_time += JOB_COLD(ctx, start_time, f_job) - f_job->arrival_time;
+
+  int deadline = JOB_COLD(ctx, deadline, f_job);
+  if (deadline >= 0){
+    if (time >= deadline)
+      histogram_record(&ctx->lateness, time - deadline);
+    else
+      histogram_record(&ctx->earliness, deadline - time);
+    if (time > deadline){
+      ctx->deadline_misses++;
+      ctx->total_tardiness += time - deadline;
+    }
+  }
+  release(ctx, core_id);
+
+  // f_job is gone once its chunk is dropped
+  JOB_CHUNK(ctx, f_job->id)->live--;
+  job_table_drop(&ctx->jobs, f_job->id >> JOB_CHUNK_BITS);
+
+  job_t n_job = next_job(ctx, core_id);
+  if (n_job == NULL)
+    return -1;
+
+  dispatch(ctx, core_id, n_job, time);
+  return n_job->id;
+}
+
+
+/**
+  When the scheme is set to RR, called when the quantum timer has expired
+  on a core.
+
+  If any job should be scheduled to run on the core free'd up by
+  the quantum expiration, return the job_number of the job that should be
+  scheduled to run on core core_id.
+
+  @param ctx the scheduler
+  @param core_id the zero-based index of the core where the quantum has expired.
+  @param time the current time of the simulator.
+  @return job_number of the job that should be scheduled on core cord_id
+  @return -1 if core should remain idle
+ */
+int scheduler_ctx_quantum_expired(scheduler_ctx_t *ctx, int core_id, int time)
+{
+  account_queues(ctx, time);
+  check_boost(ctx, time);
+  if (ctx->cores_arr[core_id] != NULL){
+    job_t job = undispatch(ctx, core_id, time);
+
+    // MLFQ: a job that used up its slice drops a level
+    if (ctx->mlfq_queues != NULL){
+      int level = JOB_COLD(ctx, level, job);
+      if (level < ctx->mlfq.levels - 1)
+        level++;
+      JOB_COLD(ctx, level, job) = level;
+      JOB_COLD(ctx, quantum_left, job) = ctx->mlfq.quantum[level];
+    }
+    enqueue(ctx, core_id, job);
+  }
+
+  job_t n_job = next_job(ctx, core_id);
+  if (n_job == NULL)
+    return -1;
+
+  dispatch(ctx, core_id, n_job, time);
+  return n_job->id;
+}
+
+
+/**
+  Returns the average waiting time of all jobs scheduled by ctx.
+
+  @param ctx the scheduler
+  @return the average waiting time of all jobs scheduled.
+ */
+float scheduler_ctx_average_waiting_time(scheduler_ctx_t *ctx)
+{
+	if(ctx->num_jobs > 0)
+	{
+		return ctx->waiting_time/ctx->num_jobs;
+	}
+  else
+	  return 0.0;
+}
+
+
+/**
+  Returns the average turnaround time of all jobs scheduled by ctx.
+
+  @param ctx the scheduler
+  @return the average turnaround time of all jobs scheduled.
+ */
+float scheduler_ctx_average_turnaround_time(scheduler_ctx_t *ctx)
+{
+	if(ctx->num_jobs > 0)
+	{
+		return ctx->turnaround_time / ctx->num_jobs;
+	}
+  else
+	   return 0.0;
+}
+
+
+/*
+ * Lateness at nearest rank permille. Early jobs rank first, the earliest
+ * of them lowest, so their rank is counted down from the top of the
+ * earliness histogram.
+ */
+static int lateness_percentile(scheduler_ctx_t *ctx, int permille)
+{
+  long long early = ctx->earliness.count;
+  long long rank = ((early + ctx->lateness.count) * permille + 999) / 1000;
+
+  if (rank < 1)
+    rank = 1;
+  if (rank <= early)
+    return -histogram_value_at(&ctx->earliness, early - rank + 1);
+  return histogram_value_at(&ctx->lateness, rank - early);
+}
+
+/**
+  Reports deadline misses, tardiness and lateness percentiles (nearest
+  rank, to within 1/64 beyond 128 time units) over the finished jobs that
+  had a deadline. All zero if none had.
+
+  @param ctx the scheduler
+  @param stats filled with the deadline statistics
+ */
+void scheduler_ctx_deadline_stats(scheduler_ctx_t *ctx, deadline_stats_t *stats)
+{
+  memset(stats, 0, sizeof(deadline_stats_t));
+  if (ctx->lateness.count + ctx->earliness.count == 0)
+    return;
+
+  stats->jobs = ctx->lateness.count + ctx->earliness.count;
+  stats->misses = ctx->deadline_misses;
+  stats->total_tardiness = ctx->total_tardiness;
+  stats->lateness_p50 = lateness_percentile(ctx, 500);
+  stats->lateness_p90 = lateness_percentile(ctx, 900);
+  stats->lateness_p99 = lateness_percentile(ctx, 990);
+  stats->max_lateness = ctx->lateness.count > 0 ? ctx->lateness.max : -ctx->earliness.min;
+}
+
+
+/**
+  Returns the average response time of all jobs scheduled by ctx.
+
+  @param ctx the scheduler
+  @return the average response time of all jobs scheduled.
+ */
+float scheduler_ctx_average_response_time(scheduler_ctx_t *ctx)
+{
+  if (ctx->num_jobs > 0)
+	  return ctx->response_time / ctx->num_jobs;
+  else
+    return 0.0;
+}
+
+
+/**
+  Returns the longest time any finished job of ctx spent waiting, which
+  shows how far aging cuts the tail that fixed priorities leave.
+
+  @param ctx the scheduler
+  @return the maximum waiting time of all jobs scheduled.
+ */
+int scheduler_ctx_max_waiting_time(scheduler_ctx_t *ctx)
+{
+  return ctx->max_waiting_time;
+}
+
+
+/* Summarizes one latency histogram. */
+static void latency_summary(const histogram_t *h, latency_stats_t *stats)
+{
+  stats->jobs = h->count;
+  stats->mean = histogram_mean(h);
+  stats->p50 = histogram_percentile(h, 500);
+  stats->p90 = histogram_percentile(h, 900);
+  stats->p99 = histogram_percentile(h, 990);
+  stats->p999 = histogram_percentile(h, 999);
+  stats->max = h->max;
+}
+
+
+/**
+  Reports the distribution of one latency metric over every job of ctx
+  that has finished.
+
+  @param ctx the scheduler
+  @param metric waiting, response or turnaround time
+  @param stats filled with the distribution
+ */
+void scheduler_ctx_latency_stats(scheduler_ctx_t *ctx, latency_metric_t metric, latency_stats_t *stats)
+{
+  latency_summary(&ctx->latency[metric], stats);
+}
+
+
+/**
+  Lists the priorities of the jobs of ctx that have finished, lowest
+  (most urgent) first. At most LATENCY_MAX_CLASSES are listed; the last
+  is LATENCY_OTHER_PRIORITIES if jobs of more priorities finished.
+
+  @param ctx the scheduler
+  @param priorities receives up to max_classes priorities
+  @param max_classes the size of priorities
+  @return the number of classes, which may exceed max_classes
+ */
+int scheduler_ctx_priority_classes(scheduler_ctx_t *ctx, int *priorities, int max_classes)
+{
+  for(int i = 0; i < ctx->num_classes && i < max_classes; i++)
+    priorities[i] = ctx->classes[i].priority;
+  return ctx->num_classes;
+}
+
+
+/**
+  Reports the distribution of one latency metric over the finished jobs
+  of ctx that had the given priority.
+
+  @param ctx the scheduler
+  @param priority the priority of the jobs to summarize
+  @param metric waiting, response or turnaround time
+  @param stats filled with the distribution
+  @return 0 on success, -1 if no job of that priority has finished
+ */
+int scheduler_ctx_priority_latency_stats(scheduler_ctx_t *ctx, int priority, latency_metric_t metric, latency_stats_t *stats)
+{
+  for(int i = 0; i < ctx->num_classes; i++){
+    if (ctx->classes[i].priority == priority){
+      latency_summary(&ctx->classes[i].latency[metric], stats);
+      return 0;
+    }
+  }
+  return -1;
+}
+
+
+/**
+  Reports how many jobs core_id of ctx finished and how busy it was,
+  measured up to the completion of the last job.
+
+  @param ctx the scheduler
+  @param core_id the zero-based index of the core
+  @param usage filled with the core's throughput and utilization
+ */
+void scheduler_ctx_core_usage(scheduler_ctx_t *ctx, int core_id, core_usage_t *usage)
+{
+  usage->jobs_finished = ctx->jobs_finished[core_id];
+  usage->busy_time = ctx->busy_time[core_id];
+  usage->throughput = ctx->end_time > 0 ? (float)usage->jobs_finished / ctx->end_time : 0.0;
+  usage->utilization = ctx->end_time > 0 ? (float)usage->busy_time / ctx->end_time : 0.0;
+}
+
+
+/**
+  Reports the run queue statistics of one core of ctx. All zero unless
+  per-core run queues are enabled.
+
+  @param ctx the scheduler
+  @param core_id the zero-based index of the core
+  @param stats filled with the statistics of core core_id
+ */
+void scheduler_ctx_core_stats(scheduler_ctx_t *ctx, int core_id, core_stats_t *stats)
+{
+  memset(stats, 0, sizeof(core_stats_t));
+  if (ctx->run_queues == NULL)
+    return;
+
+  *stats = ctx->core_stats[core_id];
+  if (ctx->last_event_time > 0)
+    stats->average_queue_length = ctx->queue_length_area[core_id] / ctx->last_event_time;
+}
+
+
+/**
+  Returns the difference between the longest and the shortest run queue
+  of ctx, averaged over time. 0 unless per-core run queues are enabled.
+
+  @param ctx the scheduler
+ */
+float scheduler_ctx_average_imbalance(scheduler_ctx_t *ctx)
+{
+  if (ctx->run_queues == NULL || ctx->last_event_time == 0)
+    return 0.0;
+  return ctx->imbalance_area / ctx->last_event_time;
+}
+
+
+/**
+  Returns the largest difference between the longest and the shortest run
+  queue of ctx that lasted at least one time unit.
+
+  @param ctx the scheduler
+ */
+int scheduler_ctx_max_imbalance(scheduler_ctx_t *ctx)
+{
+  return ctx->max_imbalance;
+}
+
+
+/* RR ignores priorities, so the queue listing shows -1 for its jobs. */
+#define SHOWN_PRIORITY(ctx, job) ((ctx)->s == RR ? -1 : (job)->priority)
+
+/**
+  Writes the jobs of ctx to out as id(priority), -1 for the priority under
+  RR: first the running jobs by core, then the queued jobs in the order
+  they are to be scheduled.
+
+  @param ctx the scheduler
+  @param out where to write the queue
+ */
+void scheduler_ctx_show_queue(scheduler_ctx_t *ctx, FILE *out)
+{
+  for(int i = 0; i < ctx->num_cores; i++){
+    if (ctx->cores_arr[i] != NULL)
+      fprintf(out, "%d(%d) ", ctx->cores_arr[i]->id, SHOWN_PRIORITY(ctx, ctx->cores_arr[i]));
+  }
+  for(int i = 0; i < priqueue_size(ctx->q); i++){
+    fprintf(out, "%d(%d) ", ((job_t) priqueue_at(ctx->q, i))->id, SHOWN_PRIORITY(ctx, (job_t) priqueue_at(ctx->q, i)));
+  }
+  for(int c = 0; ctx->run_queues && c < ctx->num_cores; c++){
+    for(int i = 0; i < priqueue_size(&ctx->run_queues[c]); i++){
+      fprintf(out, "%d(%d) ", ((job_t) priqueue_at(&ctx->run_queues[c], i))->id, SHOWN_PRIORITY(ctx, (job_t) priqueue_at(&ctx->run_queues[c], i)));
+    }
+  }
+  for(int c = 0; ctx->mlfq_queues && c < (ctx->run_queues ? ctx->num_cores : 1); c++){
+    for(int level = 0; level < ctx->mlfq.levels; level++){
+      for(int id = ctx->mlfq_queues[c].head[level]; id != -1; id = JOB_COLD(ctx, next, JOB_OF(ctx, id))){
+        fprintf(out, "%d(%d) ", id, SHOWN_PRIORITY(ctx, JOB_OF(ctx, id)));
+      }
+    }
+  }
+}
+
+
+/**
+  Sets the levels, slices and boost period of an MLFQ scheduler. Only
+  takes effect before the first job arrives; an MLFQ context starts out
+  with 3 levels of 2, 4 and 8 time units and a boost every 100.
+
+  @param ctx the scheduler
+  @param config the MLFQ shape, with 1 to MLFQ_MAX_LEVELS levels
+ */
+void scheduler_ctx_set_mlfq(scheduler_ctx_t *ctx, const mlfq_config_t *config)
+{
+  if (ctx->mlfq_queues == NULL)
+    return;
+
+  ctx->mlfq = *config;
+  ctx->next_boost = config->boost_period;
+  for(int c = 0; c < (ctx->run_queues ? ctx->num_cores : 1); c++){
+    mlfq_queue_t *mq = &ctx->mlfq_queues[c];
+    for(int level = 0; level < MLFQ_MAX_LEVELS; level++){
+      mq->head[level] = mq->tail[level] = -1;
+    }
+    mq->nonempty = 0;
+    mq->size = 0;
+  }
+}
+
+
+/**
+  Sets the target latency and minimum granularity of a CFS scheduler.
+  A CFS context starts out with a target latency of 24 time units and
+  slices of at least 3.
+
+  @param ctx the scheduler
+  @param config the CFS timing, both values positive
+ */
+void scheduler_ctx_set_cfs(scheduler_ctx_t *ctx, const cfs_config_t *config)
+{
+  if (ctx->s == CFS)
+    ctx->cfs = *config;
+}
+
+
+/**
+  Tells ctx that the job just put on core_id first waits cost time units
+  for the core to switch to it. The core counts as busy, but the job's
+  remaining time and slice only start to run down afterwards. Call it
+  after the scheduler hands a core a job, before time moves on.
+
+  @param ctx the scheduler
+  @param core_id the zero-based index of the core
+  @param cost the switch overhead in time units
+ */
+void scheduler_ctx_switch_overhead(scheduler_ctx_t *ctx, int core_id, int cost)
+{
+  if (ctx->cores_arr[core_id] == NULL || cost <= 0)
+    return;
+
+  ctx->dispatched_at[core_id] += cost;
+  ctx->busy_time[core_id] += cost;
+
+  // PSJF ranks running jobs by when they finish, which is now later
+  if (ctx->s == PSJF){
+    victim_t *v = &ctx->victim_slots[core_id];
+    v->key += cost;
+    priqueue_update_key(ctx->victims, v->handle);
+  }
+}
+
+
+/**
+  Lets PRI and PPRI jobs gain one priority level for every period time
+  units they wait in a run queue, so low-priority jobs cannot starve.
+  Only takes effect before the first job arrives; priorities are fixed
+  until it is called. Other schemes ignore it, so front ends should
+  reject aging for them.
+
+  @param ctx the scheduler
+  @param period the waiting time worth one priority level, 0 to keep priorities fixed
+ */
+void scheduler_ctx_set_aging(scheduler_ctx_t *ctx, int period)
+{
+  if (ctx->s != PRI && ctx->s != PPRI)
+    return;
+
+  ctx->aging_period = period;
+  ctx->comp = period > 0 ? compare_aging : scheme_comparer[ctx->s];
+  for(int i = -1; i < (ctx->run_queues ? ctx->num_cores : 0); i++){
+    priqueue_t *q = i < 0 ? ctx->q : &ctx->run_queues[i];
+    priqueue_destroy(q);
+    if (period > 0)
+      priqueue_init_heap_ops(q, compare_aging, &aging_heap_ops);
+    else
+      init_run_queue(q, ctx->s);
+  }
+}
+
+
+/**
+  Returns the slice the job on core_id gets before its quantum expires.
+  Under MLFQ that depends on the job's level, under CFS on its weight and
+  the load; the simulator reads it whenever a core is given a job.
+
+  @param ctx the scheduler
+  @param core_id the zero-based index of the core
+  @return the job's remaining slice, 0 if the core is idle or the scheme has no per-job slices
+ */
+int scheduler_ctx_core_quantum(scheduler_ctx_t *ctx, int core_id)
+{
+  if ((ctx->mlfq_queues == NULL && ctx->s != CFS) || ctx->cores_arr[core_id] == NULL)
+    return 0;
+  return JOB_COLD(ctx, quantum_left, ctx->cores_arr[core_id]);
+}
+
+
+/**
+  Frees a context created by scheduler_create().
+
+  @param ctx the scheduler
+ */
+void scheduler_destroy(scheduler_ctx_t *ctx)
+{
+  for(int i = 0; i < ctx->jobs.num_chunks; i++){
+    free(ctx->jobs.chunks[i]);
+  }
+  free(ctx->jobs.chunks);
+
+  priqueue_destroy(ctx->q);
+  free(ctx->q);
+  free(ctx->cores_arr);
+  free(ctx->dispatched_at);
+  free(ctx->busy_time);
+  free(ctx->jobs_finished);
+  free(ctx->classes);
+  free(ctx->idle_cores);
+
+  if (ctx->victims != NULL){
+    priqueue_destroy(ctx->victims);
+    free(ctx->victims);
+    free(ctx->victim_slots);
+  }
+  free(ctx->mlfq_queues);
+
+  if (ctx->run_queues != NULL){
+    for(int i = 0; i < ctx->num_cores; i++){
+      priqueue_destroy(&ctx->run_queues[i]);
+    }
+    free(ctx->run_queues);
+    free(ctx->core_stats);
+    free(ctx->queue_length_area);
+  }
+
+  free(ctx);
+}
+
+
+/**
+  Initalizes the scheduler.
+
+  Assumptions:
+    - You may assume this will be the first scheduler function called.
+    - You may assume this function will be called once once.
+    - You may assume that cores is a positive, non-zero number.
+    - You may assume that scheme is a valid scheduling scheme.
+
+  @param cores the number of cores that is available by the scheduler. These cores will be known as core(id=0), core(id=1), ..., core(id=cores-1).
+  @param scheme  the scheduling scheme that should be used. This value will be one of the six enum values of scheme_t
+*/
+void scheduler_start_up(int cores, scheme_t scheme)
+{
+  default_ctx = scheduler_create(cores, scheme, default_steal_policy);
+  if (scheme == MLFQ && default_mlfq.levels > 0)
+    scheduler_ctx_set_mlfq(default_ctx, &default_mlfq);
+  if (scheme == CFS && default_cfs.target_latency > 0)
+    scheduler_ctx_set_cfs(default_ctx, &default_cfs);
+  if (default_aging_period > 0)
+    scheduler_ctx_set_aging(default_ctx, default_aging_period);
+}
+
+
+/**
+  Called when a new job arrives. See scheduler_ctx_new_job().
+
+  Assumptions:
+    - You may assume that every job wil have a unique arrival time.
+
+  @param job_number a globally unique identification number of the job arriving.
+  @param time the current time of the simulator.
+  @param running_time the total number of time units this job will run before it will be finished.
+  @param priority the priority of the job. (The lower the value, the higher the priority.)
+  @return index of core job should be scheduled on
+  @return -1 if no scheduling changes should be made.
+
+ */
+int scheduler_new_job(int job_number, int time, int running_time, int priority)
+{
+  return scheduler_ctx_new_job(default_ctx, job_number, time, running_time, priority);
+}
+
+
+/**
+  Called when a new job with a deadline arrives; see
+  scheduler_ctx_new_job_deadline().
+
+  @param job_number a globally unique identification number of the job arriving.
+  @param time the current time of the simulator.
+  @param running_time the total number of time units this job will run before it will be finished.
+  @param priority the priority of the job. (The lower the value, the higher the priority.)
+  @param deadline the time the job should finish by, -1 if it has none
+  @return index of core job should be scheduled on
+  @return -1 if no scheduling changes should be made.
+ */
+int scheduler_new_job_deadline(int job_number, int time, int running_time, int priority, int deadline)
+{
+  return scheduler_ctx_new_job_deadline(default_ctx, job_number, time, running_time, priority, deadline);
+}
+
+
+/**
+  Called when a job has completed execution. See scheduler_ctx_job_finished().
+  The core_id, job_number and time parameters are provided for convenience. You may be able to calculate the values with your own data structure.
+
+  @param core_id the zero-based index of the core where the job was located.
+  @param job_number a globally unique identification number of the job.
+  @param time the current time of the simulator.
+  @return job_number of the job that should be scheduled to run on core core_id
+  @return -1 if core should remain idle.
+ */
+int scheduler_job_finished(int core_id, int job_number, int time)
+{
+  return scheduler_ctx_job_finished(default_ctx, core_id, job_number, time);
+}
+
+
+/**
+  When the scheme is set to RR, called when the quantum timer has expired
+  on a core. See scheduler_ctx_quantum_expired().
+
+  @param core_id the zero-based index of the core where the quantum has expired.
+  @param time the current time of the simulator.
+  @return job_number of the job that should be scheduled on core cord_id
+  @return -1 if core should remain idle
+ */
+int scheduler_quantum_expired(int core_id, int time)
+{
+  return scheduler_ctx_quantum_expired(default_ctx, core_id, time);
+}
+
+
+/**
+  Returns the average waiting time of all jobs scheduled by your scheduler.
+
+  Assumptions:
+    - This function will only be called after all scheduling is complete (all jobs that have arrived will have finished and no new jobs will arrive).
+  @return the average waiting time of all jobs scheduled.
+ */
+float scheduler_average_waiting_time()
+{
+  return scheduler_ctx_average_waiting_time(default_ctx);
+}
+
+
+/**
+  Returns the average turnaround time of all jobs scheduled by your scheduler.
+
+  Assumptions:
+    - This function will only be called after all scheduling is complete (all jobs that have arrived will have finished and no new jobs will arrive).
+  @return the average turnaround time of all jobs scheduled.
+ */
+float scheduler_average_turnaround_time()
+{
+  return scheduler_ctx_average_turnaround_time(default_ctx);
+}
+
+
+/**
+  Returns the average response time of all jobs scheduled by your scheduler.
+
+  Assumptions:
+    - This function will only be called after all scheduling is complete (all jobs that have arrived will have finished and no new jobs will arrive).
+  @return the average response time of all jobs scheduled.
+ */
+float scheduler_average_response_time()
+{
+  return scheduler_ctx_average_response_time(default_ctx);
+}
+
+
+/**
+  Returns the maximum waiting time of all jobs scheduled; see
+  scheduler_ctx_max_waiting_time().
+
+  @return the maximum waiting time of all jobs scheduled.
+ */
+int scheduler_max_waiting_time()
+{
+  return scheduler_ctx_max_waiting_time(default_ctx);
+}
+
+
+/**
+  Reports the distribution of one latency metric; see
+  scheduler_ctx_latency_stats().
+
+  @param metric waiting, response or turnaround time
+  @param stats filled with the distribution
+ */
+void scheduler_latency_stats(latency_metric_t metric, latency_stats_t *stats)
+{
+  scheduler_ctx_latency_stats(default_ctx, metric, stats);
+}
+
+
+/**
+  Lists the priorities of the finished jobs; see
+  scheduler_ctx_priority_classes().
+
+  @param priorities receives up to max_classes priorities
+  @param max_classes the size of priorities
+  @return the number of classes
+ */
+int scheduler_priority_classes(int *priorities, int max_classes)
+{
+  return scheduler_ctx_priority_classes(default_ctx, priorities, max_classes);
+}
+
+
+/**
+  Reports the latency distribution of one priority; see
+  scheduler_ctx_priority_latency_stats().
+
+  @param priority the priority of the jobs to summarize
+  @param metric waiting, response or turnaround time
+  @param stats filled with the distribution
+  @return 0 on success, -1 if no job of that priority has finished
+ */
+int scheduler_priority_latency_stats(int priority, latency_metric_t metric, latency_stats_t *stats)
+{
+  return scheduler_ctx_priority_latency_stats(default_ctx, priority, metric, stats);
+}
+
+
+/**
+  Reports the throughput and utilization of one core; see
+  scheduler_ctx_core_usage().
+
+  @param core_id the zero-based index of the core
+  @param usage filled with the core's throughput and utilization
+ */
+void scheduler_core_usage(int core_id, core_usage_t *usage)
+{
+  scheduler_ctx_core_usage(default_ctx, core_id, usage);
+}
+
+
+/**
+  Reports how jobs fared against their deadlines; see
+  scheduler_ctx_deadline_stats().
+
+  @param stats filled with the deadline statistics
+ */
+void scheduler_deadline_stats(deadline_stats_t *stats)
+{
+  scheduler_ctx_deadline_stats(default_ctx, stats);
+}
+
+
+/**
+  Selects whether cores share one run queue or own a run queue each and
+  steal from one another. Must be called before scheduler_start_up().
+
+  @param policy STEAL_NONE for a single shared queue, STEAL_ONE or
+  STEAL_HALF for per-core run queues
+ */
+void scheduler_set_steal_policy(steal_policy_t policy)
+{
+  default_steal_policy = policy;
+}
+
+
+/**
+  Sets the shape of the MLFQ scheme. Must be called before
+  scheduler_start_up(); see scheduler_ctx_set_mlfq().
+
+  @param config the MLFQ shape, with 1 to MLFQ_MAX_LEVELS levels
+ */
+void scheduler_set_mlfq(const mlfq_config_t *config)
+{
+  default_mlfq = *config;
+}
+
+
+/**
+  Sets the timing of the CFS scheme. Must be called before
+  scheduler_start_up(); see scheduler_ctx_set_cfs().
+
+  @param config the CFS timing, both values positive
+ */
+void scheduler_set_cfs(const cfs_config_t *config)
+{
+  default_cfs = *config;
+}
+
+
+/**
+  Tells the scheduler that core_id first spends cost time units switching
+  to its new job; see scheduler_ctx_switch_overhead().
+
+  @param core_id the zero-based index of the core
+  @param cost the switch overhead in time units
+ */
+void scheduler_switch_overhead(int core_id, int cost)
+{
+  scheduler_ctx_switch_overhead(default_ctx, core_id, cost);
+}
+
+
+/**
+  Sets the aging period of the PRI and PPRI schemes. Must be called
+  before scheduler_start_up(); see scheduler_ctx_set_aging().
+
+  @param period the waiting time worth one priority level, 0 to keep priorities fixed
+ */
+void scheduler_set_aging(int period)
+{
+  default_aging_period = period;
+}
+
+
+/**
+  Returns the slice the job on core_id gets before its quantum expires.
+  See scheduler_ctx_core_quantum().
+
+  @param core_id the zero-based index of the core
+ */
+int scheduler_core_quantum(int core_id)
+{
+  return scheduler_ctx_core_quantum(default_ctx, core_id);
+}
+
+
+/**
+  Reports the run queue statistics of one core.
+
+  @param core_id the zero-based index of the core
+  @param stats filled with the statistics of core core_id
+ */
+void scheduler_core_stats(int core_id, core_stats_t *stats)
+{
+  scheduler_ctx_core_stats(default_ctx, core_id, stats);
+}
+
+
+/**
+  Returns the time-averaged difference between the longest and the
+  shortest run queue.
+ */
+float scheduler_average_imbalance()
+{
+  return scheduler_ctx_average_imbalance(default_ctx);
+}
+
+
+/**
+  Returns the largest difference between the longest and the shortest run
+  queue that lasted at least one time unit.
+ */
+int scheduler_max_imbalance()
+{
+  return scheduler_ctx_max_imbalance(default_ctx);
+}
+
+
+/**
+  Free any memory associated with your scheduler.
+
+  Assumptions:
+    - This function will be the last function called in your library.
+*/
+void scheduler_clean_up()
+{
+  scheduler_destroy(default_ctx);
+  default_ctx = NULL;
+}
+
+
+/**
+  This function may print out any debugging information you choose. This
+  function will be called by the simulator after every call the simulator
+  makes to your scheduler.
+  In our provided output, we have implemented this function to list the jobs in the order they are to be scheduled. Furthermore, we have also listed the current state of the job (either running on a given core or idle). For example, if we have a non-preemptive algorithm and job(id=4) has began running, job(id=2) arrives with a higher priority, and job(id=1) arrives with a lower priority, the output in our sample output will be:
+
+    2(-1) 4(0) 1(-1)
+
+  This function is not required and will not be graded. You may leave it
+  blank if you do not find it useful.
+ */
+void scheduler_show_queue()
+{
+  scheduler_ctx_show_queue(default_ctx, stdout);
+}
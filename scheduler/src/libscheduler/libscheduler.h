@@ -1,57 +1,246 @@
-/** @file libscheduler.h
- */
-
-#include <stdbool.h>
-
-#ifndef LIBSCHEDULER_H_
-#define LIBSCHEDULER_H_
-
-struct _job_t;
-typedef struct _job_t
-{
-	int id;
-	int priority;
-	int arrival_time;
-	int start_time; //time starts for one of them(start -arr)
-	int running_time; // how much time run already curr - start
-	int remaining_time; // how much time left
-	int end_time; // the time it finished
-} *job_t;
-
-static job_t new_job(int job_id, int arr_time, int run_time, int priority){
-  job_t new_job = (job_t) malloc(sizeof(job_t));
-
-  new_job->id = job_id;
-  new_job->priority = priority;
-  new_job->arrival_time = arr_time;
-  new_job->start_time = 0;
-  new_job->running_time = run_time;
-  new_job->remaining_time = run_time;
-  new_job->end_time = 0;
-
-  return new_job;
-}
-
-typedef struct core_t
-{
-	bool iAmFree;
-	job_t job;
-} core_t;
-
-/**
-  Constants which represent the different scheduling algorithms
-*/
-typedef enum {FCFS = 0, SJF, PSJF, PRI, PPRI, RR} scheme_t;
-
-void  scheduler_start_up               (int cores, scheme_t scheme);
-int   scheduler_new_job                (int job_number, int time, int running_time, int priority);
-int   scheduler_job_finished           (int core_id, int job_number, int time);
-int   scheduler_quantum_expired        (int core_id, int time);
-float scheduler_average_turnaround_time();
-float scheduler_average_waiting_time   ();
-float scheduler_average_response_time  ();
-void  scheduler_clean_up               ();
-
-void  scheduler_show_queue             ();
-
-#endif /* LIBSCHEDULER_H_ */
+/** @file libscheduler.h
+ */
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <limits.h>
+
+#ifndef LIBSCHEDULER_H_
+#define LIBSCHEDULER_H_
+
+struct _job_t;
+/**
+  Hot part of a job: everything the comparer and the per-arrival
+  bookkeeping touch. Kept small so a cache line holds several jobs.
+*/
+typedef struct _job_t
+{
+	int id;
+	int priority;
+	int arrival_time;
+	int running_time; // total time the job needs on a core
+	int remaining_time; // time left when it was last put on or taken off a core
+} *job_t;
+
+#define JOB_CHUNK_BITS 12
+#define JOB_CHUNK_SIZE (1 << JOB_CHUNK_BITS)
+#define JOB_CHUNK_MASK (JOB_CHUNK_SIZE - 1)
+
+/**
+  Fixed-size slab of the job table. Hot fields are stored as an array of
+  job structs, cold per-job statistics as parallel arrays indexed the same
+  way. Chunks never move, so job_t pointers stay valid while queued.
+  A chunk is freed once every job put in it has finished and newer ids
+  have moved on to a later chunk.
+*/
+typedef struct _job_chunk_t
+{
+	struct _job_t hot[JOB_CHUNK_SIZE];
+	int start_time[JOB_CHUNK_SIZE]; // first time unit the job ran, -1 if never
+	int level[JOB_CHUNK_SIZE]; // MLFQ: level the job was last queued or run at
+	int quantum_left[JOB_CHUNK_SIZE]; // MLFQ, CFS: time left of the job's current slice
+	int next[JOB_CHUNK_SIZE]; // MLFQ: next job id in the same level queue, -1 at the tail
+	long long vruntime[JOB_CHUNK_SIZE]; // CFS: time run so far, scaled by the job's weight
+	int deadline[JOB_CHUNK_SIZE]; // time the job should finish by, -1 if it has none
+	long long aging_key[JOB_CHUNK_SIZE]; // PRI, PPRI with aging: priority scaled by the period plus when the job began waiting
+	int live; // jobs added to the chunk that have not finished
+} job_chunk_t;
+
+/**
+  Arena of every job seen during a run, indexed by job id.
+*/
+typedef struct _job_table_t
+{
+	job_chunk_t **chunks; // NULL where no job was added or every job has finished
+	int num_chunks;
+	int newest; // chunk of the last job added, kept even when it empties
+} job_table_t;
+
+typedef struct core_t
+{
+	bool iAmFree;
+	job_t job;
+} core_t;
+
+/**
+  Constants which represent the different scheduling algorithms
+*/
+typedef enum {FCFS = 0, SJF, PSJF, PRI, PPRI, RR, MLFQ, CFS, EDF} scheme_t;
+
+#define MLFQ_MAX_LEVELS 32
+
+/**
+  Shape of the MLFQ scheme. Jobs arrive at level 0, drop a level each
+  time they use up their slice and run round robin within a level; the
+  highest non-empty level always runs first and preempts lower levels.
+*/
+typedef struct _mlfq_config_t
+{
+	int levels;
+	int quantum[MLFQ_MAX_LEVELS]; // slice of each level, level 0 first
+	int boost_period; // every boost_period time units, queued jobs go back to level 0 (0: never)
+} mlfq_config_t;
+
+#define MLFQ_DEFAULT_CONFIG { 3, { 2, 4, 8 }, 100 }
+
+/**
+  Timing of the CFS scheme. The job with the least weighted run time runs
+  next; priority acts as a nice value, so priority 0 has the nominal
+  weight and every step up or down changes a job's share by about 25%.
+  A job's slice is its share of target_latency among the runnable jobs
+  on each core, but never less than min_granularity.
+
+  Unlike Linux there is no wakeup preemption: when every core is busy, a
+  new job waits for a running job's slice to end, however little it has
+  run. New jobs start at
+  min_vruntime, which is kept for all cores together and only moves up
+  when a job is dispatched.
+*/
+typedef struct _cfs_config_t
+{
+	int target_latency; // period in which every runnable job should run once
+	int min_granularity; // shortest slice, however many jobs are runnable
+} cfs_config_t;
+
+#define CFS_DEFAULT_CONFIG { 24, 3 }
+
+/**
+  How queued jobs are shared between cores. With STEAL_NONE every core
+  pulls from one global queue; otherwise each core owns a run queue and
+  an idle core steals one job, or half the queue, from the longest peer.
+*/
+typedef enum {STEAL_NONE = 0, STEAL_ONE, STEAL_HALF} steal_policy_t;
+
+/**
+  Per-core run queue statistics, averaged over time.
+*/
+typedef struct _core_stats_t
+{
+	float average_queue_length;
+	int max_queue_length;
+	unsigned long steals; // times this core took work from a peer
+	unsigned long stolen_jobs; // jobs moved to this core by those steals
+} core_stats_t;
+
+/**
+  How finished jobs that had a deadline fared against it. Lateness is
+  finish time minus deadline, negative for jobs that finished early;
+  tardiness is lateness where it is positive.
+*/
+typedef struct _deadline_stats_t
+{
+	int jobs; // finished jobs that had a deadline
+	int misses; // of those, jobs that finished after their deadline
+	long long total_tardiness;
+	int lateness_p50;
+	int lateness_p90;
+	int lateness_p99;
+	int max_lateness;
+} deadline_stats_t;
+
+/**
+  Per-job times that finished jobs are summarized by.
+*/
+typedef enum {LATENCY_WAITING = 0, LATENCY_RESPONSE, LATENCY_TURNAROUND, LATENCY_METRICS} latency_metric_t;
+
+/**
+  Most priorities whose latency is kept apart. Once all but one are
+  taken, jobs of any other priority share the last class, reported as
+  priority LATENCY_OTHER_PRIORITIES, so per-priority statistics take
+  bounded memory whatever the trace.
+*/
+#define LATENCY_MAX_CLASSES 32
+#define LATENCY_OTHER_PRIORITIES INT_MAX
+
+/**
+  Distribution of one latency metric over finished jobs. Percentiles
+  come from a log-linear histogram and are within 1.6% of the exact
+  value; the mean and maximum are exact.
+*/
+typedef struct _latency_stats_t
+{
+  long long jobs;
+  double mean;
+  int p50;
+  int p90;
+  int p99;
+  int p999;
+  int max;
+} latency_stats_t;
+
+/**
+  How busy one core was between time 0 and the last job's completion.
+*/
+typedef struct _core_usage_t
+{
+  int jobs_finished; // jobs that completed on this core
+  long long busy_time; // time units the core ran a job
+  float throughput; // jobs finished per time unit
+  float utilization; // fraction of the time the core ran a job
+} core_usage_t;
+
+/**
+  Opaque state of one scheduler instance. Contexts share nothing, so
+  each may be driven from its own thread without locking; a single
+  context is not safe to use from two threads at once.
+
+  The scheduler_* functions without a context operate on a default
+  context created by scheduler_start_up().
+*/
+typedef struct _scheduler_ctx_t scheduler_ctx_t;
+
+scheduler_ctx_t* scheduler_create      (int cores, scheme_t scheme, steal_policy_t steal);
+int   scheduler_ctx_new_job            (scheduler_ctx_t *ctx, int job_number, int time, int running_time, int priority);
+int   scheduler_ctx_new_job_deadline   (scheduler_ctx_t *ctx, int job_number, int time, int running_time, int priority, int deadline);
+int   scheduler_ctx_job_finished       (scheduler_ctx_t *ctx, int core_id, int job_number, int time);
+int   scheduler_ctx_quantum_expired    (scheduler_ctx_t *ctx, int core_id, int time);
+float scheduler_ctx_average_turnaround_time(scheduler_ctx_t *ctx);
+float scheduler_ctx_average_waiting_time   (scheduler_ctx_t *ctx);
+float scheduler_ctx_average_response_time  (scheduler_ctx_t *ctx);
+int   scheduler_ctx_max_waiting_time   (scheduler_ctx_t *ctx);
+void  scheduler_ctx_latency_stats      (scheduler_ctx_t *ctx, latency_metric_t metric, latency_stats_t *stats);
+int   scheduler_ctx_priority_classes   (scheduler_ctx_t *ctx, int *priorities, int max_classes);
+int   scheduler_ctx_priority_latency_stats(scheduler_ctx_t *ctx, int priority, latency_metric_t metric, latency_stats_t *stats);
+void  scheduler_ctx_core_usage         (scheduler_ctx_t *ctx, int core_id, core_usage_t *usage);
+void  scheduler_ctx_deadline_stats     (scheduler_ctx_t *ctx, deadline_stats_t *stats);
+void  scheduler_ctx_core_stats         (scheduler_ctx_t *ctx, int core_id, core_stats_t *stats);
+float scheduler_ctx_average_imbalance  (scheduler_ctx_t *ctx);
+int   scheduler_ctx_max_imbalance      (scheduler_ctx_t *ctx);
+void  scheduler_ctx_show_queue         (scheduler_ctx_t *ctx, FILE *out);
+void  scheduler_ctx_set_mlfq           (scheduler_ctx_t *ctx, const mlfq_config_t *config);
+int   scheduler_ctx_core_quantum       (scheduler_ctx_t *ctx, int core_id);
+void  scheduler_ctx_set_cfs            (scheduler_ctx_t *ctx, const cfs_config_t *config);
+void  scheduler_ctx_set_aging          (scheduler_ctx_t *ctx, int period);
+void  scheduler_ctx_switch_overhead    (scheduler_ctx_t *ctx, int core_id, int cost);
+void  scheduler_destroy                (scheduler_ctx_t *ctx);
+
+void  scheduler_start_up               (int cores, scheme_t scheme);
+int   scheduler_new_job                (int job_number, int time, int running_time, int priority);
+int   scheduler_new_job_deadline       (int job_number, int time, int running_time, int priority, int deadline);
+int   scheduler_job_finished           (int core_id, int job_number, int time);
+int   scheduler_quantum_expired        (int core_id, int time);
+float scheduler_average_turnaround_time();
+float scheduler_average_waiting_time   ();
+float scheduler_average_response_time  ();
+int   scheduler_max_waiting_time       ();
+void  scheduler_latency_stats          (latency_metric_t metric, latency_stats_t *stats);
+int   scheduler_priority_classes       (int *priorities, int max_classes);
+int   scheduler_priority_latency_stats (int priority, latency_metric_t metric, latency_stats_t *stats);
+void  scheduler_core_usage             (int core_id, core_usage_t *usage);
+void  scheduler_deadline_stats         (deadline_stats_t *stats);
+void  scheduler_clean_up               ();
+
+void  scheduler_set_steal_policy       (steal_policy_t policy);
+void  scheduler_core_stats             (int core_id, core_stats_t *stats);
+float scheduler_average_imbalance      ();
+int   scheduler_max_imbalance          ();
+
+void  scheduler_set_mlfq               (const mlfq_config_t *config);
+int   scheduler_core_quantum           (int core_id);
+void  scheduler_set_cfs                (const cfs_config_t *config);
+void  scheduler_set_aging              (int period);
+void  scheduler_switch_overhead        (int core_id, int cost);
+
+void  scheduler_show_queue             ();
+
+#endif /* LIBSCHEDULER_H_ */
@@ -0,0 +1,693 @@
+/** @file libsimulation.c
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+#include "libsimulation.h"
+#include "../libpriqueue/libpriqueue_heap.h"
+
+/*
+ * Grows *array of *capacity elements of size bytes to hold at least need,
+ * doubling, and exits if memory runs out.
+ */
+static void *grow(void *array, int *capacity, int need, size_t size)
+{
+	if (need <= *capacity)
+		return array;
+
+	while (*capacity < need)
+		*capacity = *capacity ? *capacity * 2 : 16;
+	array = realloc(array, *capacity * size);
+
+	if (!array)
+	{
+		fprintf(stderr, "Out of memory.\n");
+		exit(2);
+	}
+	return array;
+}
+
+/*
+ * Returns how long core_id's job may run before its quantum expires.
+ */
+static int core_quantum(simulation_t *sim, int core_id)
+{
+	return sim->scheme == MLFQ || sim->scheme == CFS ? scheduler_ctx_core_quantum(sim->ctx, core_id) : sim->quantum;
+}
+
+/* Orders core events by time. */
+static int compare_core_event(const void *a, const void *b)
+{
+	return ((const simulation_core_event_t *)a)->time - ((const simulation_core_event_t *)b)->time;
+}
+
+PRIQUEUE_HEAP_SPECIALIZE(core_event, compare_core_event);
+
+/*
+ * Brings core c's counters up to sim->time and marks the core changed.
+ * Called before a step changes the core's job, stall or quantum. Between
+ * its events a core either stalls or runs its job the whole time.
+ */
+static void touch_core(simulation_t *sim, int c)
+{
+	int elapsed = sim->time - sim->since[c], i = sim->running[c];
+
+	if (sim->is_changed[c])
+		return;
+	sim->is_changed[c] = 1;
+	sim->changed[sim->changed_count++] = c;
+	sim->since[c] = sim->time;
+
+	if (i == -1 || elapsed == 0)
+		return;
+	if (sim->stall[c] > 0)
+	{
+		sim->stall[c] -= elapsed;
+		sim->overhead[c] += elapsed;
+	}
+	else
+	{
+		sim->jobs[i].run_time -= elapsed;
+		sim->quantum_clock[c] -= elapsed;
+	}
+}
+
+static int compare_core_id(const void *a, const void *b)
+{
+	return *(const int *)a - *(const int *)b;
+}
+
+/*
+ * Orders the changed cores by core id, so events are handled in the same
+ * order whether or not the heap is used.
+ */
+static void sort_changed_cores(simulation_t *sim)
+{
+	int i, j;
+
+	if (sim->changed_count > 32)
+	{
+		qsort(sim->changed, sim->changed_count, sizeof(int), compare_core_id);
+		return;
+	}
+
+	// Usually only a few cores change in a step
+	for (i = 1; i < sim->changed_count; i++)
+	{
+		int c = sim->changed[i];
+		for (j = i; j > 0 && sim->changed[j - 1] > c; j--)
+			sim->changed[j] = sim->changed[j - 1];
+		sim->changed[j] = c;
+	}
+}
+
+/*
+ * Starts a step: touches every core whose event is due.
+ */
+static void take_due_cores(simulation_t *sim)
+{
+	simulation_core_event_t *event;
+	int c;
+
+	if (!sim->use_heap)
+	{
+		// Found in core order, so nothing to sort
+		for (c = 0; c < sim->cores; c++)
+		{
+			event = &sim->core_events[c];
+			if (event->queued && event->time <= sim->time)
+			{
+				event->queued = 0;
+				sim->busy_cores--;
+				touch_core(sim, c);
+			}
+		}
+		return;
+	}
+
+	while ((event = priqueue_peek(&sim->next_events)) != NULL && event->time <= sim->time)
+	{
+		priqueue_poll(&sim->next_events);
+		event->queued = 0;
+		sim->busy_cores--;
+		touch_core(sim, event->core_id);
+	}
+	sort_changed_cores(sim);
+}
+
+/*
+ * Ends a step: sets the next event of every changed core that is busy and
+ * queues it again, and drops the idle ones.
+ */
+static void queue_changed_cores(simulation_t *sim)
+{
+	int k;
+
+	for (k = 0; k < sim->changed_count; k++)
+	{
+		int c = sim->changed[k], i = sim->running[c];
+		simulation_core_event_t *event = &sim->core_events[c];
+
+		sim->is_changed[c] = 0;
+		if (i == -1)
+		{
+			if (event->queued)
+			{
+				if (sim->use_heap)
+					priqueue_remove_handle(&sim->next_events, event->handle);
+				sim->busy_cores--;
+			}
+			event->queued = 0;
+			continue;
+		}
+
+		if (sim->stall[c] > 0)
+			event->time = sim->time + sim->stall[c];
+		else
+		{
+			event->time = sim->time + sim->jobs[i].run_time;
+			if (sim->uses_quantum && sim->quantum_clock[c] < sim->jobs[i].run_time)
+				event->time = sim->time + sim->quantum_clock[c];
+		}
+
+		if (sim->use_heap && event->queued)
+			priqueue_update_key(&sim->next_events, event->handle);
+		else if (sim->use_heap)
+			priqueue_offer_handle(&sim->next_events, event, &event->handle);
+		if (!event->queued)
+			sim->busy_cores++;
+		event->queued = 1;
+	}
+	sim->changed_count = 0;
+}
+
+/*
+ * Puts job_id on core_id. Returns 0 if job_id is not an active job.
+ */
+static int set_active_job(simulation_t *sim, int job_id, int core_id)
+{
+	if (job_id < sim->slot_base || job_id >= sim->known_jobs || sim->slot[job_id - sim->slot_base] == -1)
+		return 0;
+
+	int i = sim->slot[job_id - sim->slot_base];
+	if (!sim->jobs[i].arrived)
+		return 0;
+	if (sim->jobs[i].core_id != -1)
+	{
+		touch_core(sim, sim->jobs[i].core_id);
+		sim->running[sim->jobs[i].core_id] = -1;
+	}
+
+	sim->jobs[i].core_id = core_id;
+	sim->running[core_id] = i;
+	return 1;
+}
+
+#ifdef SIMULATOR_DEBUG
+/*
+ * Cross-checks the job index and the core occupancy against the active jobs.
+ * Only built into debug builds ('make debug'): it scans every active job.
+ */
+static void check_invariants(simulation_t *sim)
+{
+	int i, c, busy = 0;
+
+	for (i = 0; i < sim->active_jobs; i++)
+	{
+		assert(sim->jobs[i].arrived);
+		assert(sim->slot[sim->jobs[i].job_id - sim->slot_base] == i);
+		if (sim->jobs[i].core_id != -1)
+		{
+			assert(sim->running[sim->jobs[i].core_id] == i);
+			busy++;
+		}
+	}
+
+	for (c = 0; c < sim->cores; c++)
+	{
+		if (sim->running[c] != -1)
+		{
+			assert(sim->running[c] < sim->active_jobs && sim->jobs[sim->running[c]].core_id == c);
+			busy--;
+		}
+	}
+	assert(busy == 0);
+}
+#endif
+
+/*
+ * The simulator used to keep every job in one array, deleting finished jobs
+ * by moving the last job into their slot, and reported simultaneous finishes
+ * and arrivals in that array order. The order is kept here (slot -> job id
+ * and job id -> slot) so the scheduler still sees events in the same order.
+ */
+static void report_order_remove(simulation_t *sim, int job_id)
+{
+	int last = sim->order[--sim->order_count];
+
+	sim->order[sim->order_position[job_id]] = last;
+	sim->order_position[last] = sim->order_position[job_id];
+}
+
+static void report_order_sort(simulation_job_t *jobs, int n, int *position)
+{
+	int i, j;
+	for (i = 1; i < n; i++)
+	{
+		simulation_job_t job = jobs[i];
+		for (j = i; j > 0 && position[jobs[j - 1].job_id] > position[job.job_id]; j--)
+			jobs[j] = jobs[j - 1];
+		jobs[j] = job;
+	}
+}
+
+/*
+ * Makes room in slot[] for job_id. Without a report order jobs arrive in
+ * id order, so the ids before the oldest active job are dropped from the
+ * front instead of being kept for the whole run: a stream needs room for
+ * the ids its active jobs span, not for every job it has read.
+ */
+static void reserve_slot(simulation_t *sim, int job_id)
+{
+	int used = sim->known_jobs - sim->slot_base, dead = 0;
+
+	if (job_id - sim->slot_base >= sim->slot_capacity && sim->order == NULL)
+	{
+		while (dead < used && sim->slot[dead] == -1)
+			dead++;
+		if (dead > 0)
+		{
+			memmove(sim->slot, sim->slot + dead, (used - dead) * sizeof(int));
+			sim->slot_base += dead;
+		}
+
+		// Leave as much room again, so the window is not moved on every arrival
+		sim->slot = grow(sim->slot, &sim->slot_capacity, 2 * (job_id - sim->slot_base + 1), sizeof(int));
+	}
+	else
+		sim->slot = grow(sim->slot, &sim->slot_capacity, job_id - sim->slot_base + 1, sizeof(int));
+
+	for (; sim->known_jobs <= job_id; sim->known_jobs++)
+		sim->slot[sim->known_jobs - sim->slot_base] = -1;
+}
+
+/* A job that finished on core_id, ranked by report order. */
+typedef struct _finished_job_t
+{
+	int job_id, core_id, rank;
+} finished_job_t;
+
+static int compare_finished(const void *a, const void *b)
+{
+	return ((const finished_job_t *)a)->rank - ((const finished_job_t *)b)->rank;
+}
+
+/*
+ * 1. Reports the jobs that finished in the last time unit to the scheduler,
+ * in report order. Only cores with a due event can have finished.
+ *
+ * Removing a job from the report order moves the job last in it into its
+ * place, so when that job finished too it is reported next; otherwise the
+ * order of the rest is unchanged.
+ */
+static simulation_status_t finish_jobs(simulation_t *sim)
+{
+	finished_job_t list[sim->cores];
+	int finished = 0, moved = 0, k;
+
+	for (k = 0; k < sim->changed_count; k++)
+	{
+		int c = sim->changed[k], i = sim->running[c];
+		if (i != -1 && sim->jobs[i].run_time == 0)
+		{
+			int job_id = sim->jobs[i].job_id;
+			list[finished++] = (finished_job_t){ job_id, c, sim->order_position != NULL ? sim->order_position[job_id] : job_id };
+		}
+	}
+	if (finished > 1)
+		qsort(list, finished, sizeof(finished_job_t), compare_finished);
+
+	int front = 0, back = finished - 1;
+	while (front <= back)
+	{
+		finished_job_t *job = moved ? &list[back--] : &list[front++];
+		int job_id = job->job_id;
+		int core_id = job->core_id;
+		int i = sim->running[core_id];
+
+		int new_job_id = scheduler_ctx_job_finished(sim->ctx, core_id, job_id, sim->time);
+		sim->events++;
+
+		if (sim->uses_quantum)
+			sim->quantum_clock[core_id] = core_quantum(sim, core_id);
+
+		// Delete the finished job by moving the last active job into its place
+		if (sim->order != NULL)
+		{
+			moved = front <= back && sim->order[sim->order_count - 1] == list[back].job_id;
+			report_order_remove(sim, job_id);
+		}
+		sim->running[core_id] = -1;
+		sim->slot[job_id - sim->slot_base] = -1;
+		if (i != sim->active_jobs - 1)
+		{
+			sim->jobs[i] = sim->jobs[sim->active_jobs - 1];
+			sim->slot[sim->jobs[i].job_id - sim->slot_base] = i;
+			if (sim->jobs[i].core_id != -1)
+				sim->running[sim->jobs[i].core_id] = i;
+		}
+		sim->active_jobs--;
+
+		if (new_job_id != -1 && !set_active_job(sim, new_job_id, core_id))
+		{
+			sim->bad_value = new_job_id;
+			return SIMULATION_BAD_FINISHED_JOB;
+		}
+		if (sim->hooks.finished != NULL)
+			sim->hooks.finished(sim, job_id, core_id, new_job_id);
+	}
+
+	return SIMULATION_DONE;
+}
+
+/*
+ * 2. Reports the quanta that expired in the last time unit, on the first
+ * due cores of the changed list in core order.
+ */
+static simulation_status_t expire_quanta(simulation_t *sim, int due)
+{
+	int c, i, k;
+
+	for (k = 0; k < due; k++)
+	{
+		if (sim->quantum_clock[c = sim->changed[k]] != 0 || (i = sim->running[c]) == -1)
+			continue;
+
+		int old_job_id = sim->jobs[i].job_id;
+		int new_job_id = scheduler_ctx_quantum_expired(sim->ctx, c, sim->time);
+		sim->events++;
+
+		sim->jobs[i].core_id = -1;
+		sim->running[c] = -1;
+		sim->quantum_clock[c] = core_quantum(sim, c);
+
+		if (new_job_id != -1 && !set_active_job(sim, new_job_id, c))
+		{
+			sim->bad_value = new_job_id;
+			return SIMULATION_BAD_EXPIRED_JOB;
+		}
+		if (sim->hooks.expired != NULL)
+			sim->hooks.expired(sim, old_job_id, c, new_job_id);
+	}
+
+	return SIMULATION_DONE;
+}
+
+/*
+ * 3. Hands the jobs arriving at this time to the scheduler.
+ */
+static simulation_status_t admit_arrivals(simulation_t *sim)
+{
+	if (sim->hooks.arrivals != NULL && sim->hooks.arrivals(sim) != 0)
+		return SIMULATION_BAD_TRACE;
+
+	int arrivals_end = sim->next_arrival;
+	while (arrivals_end < sim->trace_count && sim->trace[arrivals_end].arrival_time <= sim->time)
+		arrivals_end++;
+
+	if (sim->order_position != NULL)
+		report_order_sort(&sim->trace[sim->next_arrival], arrivals_end - sim->next_arrival, sim->order_position);
+
+	while (sim->next_arrival < arrivals_end)
+	{
+		sim->jobs = grow(sim->jobs, &sim->jobs_capacity, sim->active_jobs + 1, sizeof(simulation_job_t));
+
+		int i = sim->active_jobs++;
+		simulation_job_t *job = &sim->jobs[i];
+		*job = sim->trace[sim->next_arrival++];
+
+		reserve_slot(sim, job->job_id);
+		sim->slot[job->job_id - sim->slot_base] = i;
+
+		int core_id = scheduler_ctx_new_job_deadline(sim->ctx, job->job_id, sim->time, job->run_time, job->priority, job->deadline);
+		sim->events++;
+		job->arrived = 1;
+
+		if (core_id < -1 || core_id >= sim->cores)
+		{
+			sim->bad_value = core_id;
+			return SIMULATION_BAD_CORE;
+		}
+		if (sim->hooks.arrived != NULL)
+			sim->hooks.arrived(sim, job, core_id);
+		if (core_id == -1)
+			continue;
+
+		// Take the core from whoever is currently using it
+		touch_core(sim, core_id);
+		if (sim->running[core_id] != -1)
+			sim->jobs[sim->running[core_id]].core_id = -1;
+
+		job->core_id = core_id;
+		sim->running[core_id] = i;
+
+		if (sim->uses_quantum)
+			sim->quantum_clock[core_id] = core_quantum(sim, core_id);
+	}
+
+	return SIMULATION_DONE;
+}
+
+/*
+ * A core starting a job other than the one it ran last first stalls for
+ * the switch cost, plus the migration cost if the job's cache is warm on
+ * another core. The job makes no progress and its quantum does not run
+ * down until the stall is over. Only changed cores can have switched.
+ */
+static void charge_switches(simulation_t *sim)
+{
+	int c, i, k;
+
+	for (k = 0; k < sim->changed_count; k++)
+	{
+		c = sim->changed[k];
+		if ((i = sim->running[c]) == -1)
+			sim->stall[c] = 0;
+		if (i == -1 || sim->jobs[i].job_id == sim->last_job[c])
+			continue;
+
+		sim->stall[c] = sim->switch_cost;
+		sim->switches[c]++;
+		if (sim->jobs[i].last_core != -1 && sim->jobs[i].last_core != c)
+		{
+			sim->stall[c] += sim->migration_cost;
+			sim->migrations[c]++;
+		}
+		scheduler_ctx_switch_overhead(sim->ctx, c, sim->stall[c]);
+		sim->jobs[i].last_core = c;
+		sim->last_job[c] = sim->jobs[i].job_id;
+	}
+}
+
+/*
+ * Returns how many units to run at once: 1, or in event-driven mode every
+ * unit up to the next event, since nothing changes until a job finishes,
+ * a quantum expires, a stall ends or a job arrives.
+ */
+static int next_span(simulation_t *sim)
+{
+	simulation_core_event_t *event = NULL;
+	int span, c;
+
+	if (!sim->event_driven)
+		return 1;
+
+	if (sim->use_heap)
+		event = priqueue_peek(&sim->next_events);
+	else
+		for (c = 0; c < sim->cores; c++)
+			if (sim->core_events[c].queued && (event == NULL || sim->core_events[c].time < event->time))
+				event = &sim->core_events[c];
+
+	span = (sim->next_arrival < sim->trace_count) ? sim->trace[sim->next_arrival].arrival_time - sim->time : -1;
+	if (event != NULL && (span == -1 || event->time - sim->time < span))
+		span = event->time - sim->time;
+
+	return span < 1 ? 1 : span;
+}
+
+
+/**
+  Prepares a simulation of trace, which must be in arrival order (see
+  simulation_compare_arrival()), on ctx. Options such as event_driven and
+  the switch costs, and the hooks, may be set in sim afterwards.
+
+  @param sim the simulation to initialize
+  @param ctx a fresh scheduler context for cores and scheme
+  @param cores the number of cores
+  @param scheme the scheme of ctx
+  @param quantum the quantum when scheme is RR
+  @param trace the arrival list
+  @param trace_count the number of jobs in trace
+  @param report_order if not 0, trace holds job ids 0 to trace_count - 1 and
+	simultaneous finishes and arrivals are reported in the order the
+	original simulator's job array had them; otherwise in job id order
+ */
+void simulation_init(simulation_t *sim, scheduler_ctx_t *ctx, int cores, scheme_t scheme, int quantum,
+                     simulation_job_t *trace, int trace_count, int report_order)
+{
+	int i;
+
+	memset(sim, 0, sizeof(simulation_t));
+	sim->ctx = ctx;
+	sim->cores = cores;
+	sim->scheme = scheme;
+	sim->quantum = quantum;
+	sim->trace = trace;
+	sim->trace_count = trace_count;
+	sim->uses_quantum = scheme == RR || scheme == MLFQ || scheme == CFS;
+
+	sim->running = malloc(cores * sizeof(int));
+	sim->quantum_clock = malloc(cores * sizeof(int));
+	sim->last_job = malloc(cores * sizeof(int));
+	sim->stall = calloc(cores, sizeof(int));
+	sim->switches = calloc(cores, sizeof(unsigned long));
+	sim->migrations = calloc(cores, sizeof(unsigned long));
+	sim->overhead = calloc(cores, sizeof(long long));
+	for (i = 0; i < cores; i++)
+		sim->running[i] = sim->quantum_clock[i] = sim->last_job[i] = -1;
+
+	sim->use_heap = cores > SIMULATION_HEAP_CORES;
+	priqueue_init_heap_ops(&sim->next_events, compare_core_event, &core_event_heap_ops);
+	sim->core_events = calloc(cores, sizeof(simulation_core_event_t));
+	sim->since = calloc(cores, sizeof(int));
+	sim->changed = malloc(cores * sizeof(int));
+	sim->is_changed = calloc(cores, sizeof(int));
+	for (i = 0; i < cores; i++)
+		sim->core_events[i].core_id = i;
+
+	if (report_order)
+	{
+		sim->order = malloc(trace_count * sizeof(int));
+		sim->order_position = malloc(trace_count * sizeof(int));
+		sim->order_count = trace_count;
+
+		for (i = 0; i < trace_count; i++)
+			sim->order[i] = sim->order_position[i] = i;
+	}
+}
+
+
+/**
+  Runs the simulation until every job finished or something went wrong.
+  On return sim->time is the time the last job finished.
+
+  @param sim an initialized simulation
+  @return SIMULATION_DONE, or why the run stopped
+ */
+simulation_status_t simulation_run(simulation_t *sim)
+{
+	simulation_status_t status;
+	int due;
+
+	if (sim->hooks.arrivals != NULL && sim->hooks.arrivals(sim) != 0)
+		return SIMULATION_BAD_TRACE;
+
+	while (sim->active_jobs > 0 || sim->next_arrival < sim->trace_count)
+	{
+		if (sim->hooks.step != NULL)
+			sim->hooks.step(sim);
+
+		take_due_cores(sim);
+		due = sim->changed_count;
+
+		if ((status = finish_jobs(sim)) != SIMULATION_DONE)
+			return status;
+
+		// Stop here after the last job, rather than run a time unit that is totally idle
+		if (sim->active_jobs == 0 && sim->next_arrival == sim->trace_count)
+			break;
+
+		if (sim->uses_quantum && (status = expire_quanta(sim, due)) != SIMULATION_DONE)
+			return status;
+
+		if ((status = admit_arrivals(sim)) != SIMULATION_DONE)
+			return status;
+
+#ifdef SIMULATOR_DEBUG
+		check_invariants(sim);
+#endif
+
+		/*
+		 * 4. Run the time unit, or every unit up to the next event. Busy
+		 * cores catch up when they are next touched.
+		 */
+		if (sim->count_switches)
+		{
+			sort_changed_cores(sim);
+			charge_switches(sim);
+		}
+		queue_changed_cores(sim);
+
+		int span = next_span(sim);
+
+		if (sim->hooks.ran != NULL)
+			sim->hooks.ran(sim, span);
+
+		// A job is waiting to run but the scheduler left every core idle
+		if (sim->active_jobs > 0 && sim->busy_cores == 0)
+			return SIMULATION_ALL_IDLE;
+
+		sim->time += span;
+	}
+
+	return SIMULATION_DONE;
+}
+
+
+/**
+  Frees what simulation_init() and simulation_run() allocated. Neither
+  the scheduler context nor the arrival list is freed.
+
+  @param sim the simulation
+ */
+void simulation_destroy(simulation_t *sim)
+{
+	free(sim->jobs);
+	free(sim->running);
+	free(sim->slot);
+	free(sim->order);
+	free(sim->order_position);
+	free(sim->quantum_clock);
+	free(sim->last_job);
+	free(sim->stall);
+	free(sim->switches);
+	free(sim->migrations);
+	free(sim->overhead);
+	priqueue_destroy(&sim->next_events);
+	free(sim->core_events);
+	free(sim->since);
+	free(sim->changed);
+	free(sim->is_changed);
+}
+
+
+/**
+  Orders jobs by arrival time, then job id: the order simulation_init()
+  expects the arrival list in.
+
+  @param a a simulation_job_t
+  @param b a simulation_job_t
+  @return negative, zero or positive as a arrives before, with or after b
+ */
+int simulation_compare_arrival(const void *a, const void *b)
+{
+	const simulation_job_t *job_a = a, *job_b = b;
+
+	if (job_a->arrival_time != job_b->arrival_time)
+		return job_a->arrival_time - job_b->arrival_time;
+	return job_a->job_id - job_b->job_id;
+}
@@ -0,0 +1,146 @@
+/** @file libsimulation.h
+ */
+
+#ifndef LIBSIMULATION_H_
+#define LIBSIMULATION_H_
+
+#include "../libscheduler/libscheduler.h"
+#include "../libpriqueue/libpriqueue.h"
+
+/**
+  A job of the trace being simulated: as read, then how far it got.
+*/
+typedef struct _simulation_job_t
+{
+	int job_id, arrival_time, run_time, priority, deadline;
+	int core_id, arrived;
+	int last_core; // core the job last ran on, -1 before its first run
+} simulation_job_t;
+
+/**
+  How a simulation ended. Anything but SIMULATION_DONE means the
+  scheduler, or a streamed trace, broke the rules; bad_value in
+  simulation_t holds the offending job or core.
+*/
+typedef enum
+{
+	SIMULATION_DONE = 0,
+	SIMULATION_BAD_FINISHED_JOB, // scheduler_job_finished() picked a job that is not active
+	SIMULATION_BAD_EXPIRED_JOB, // scheduler_quantum_expired() picked a job that is not active
+	SIMULATION_BAD_CORE, // scheduler_new_job() picked a core that does not exist
+	SIMULATION_ALL_IDLE, // every core is idle while jobs remain
+	SIMULATION_BAD_TRACE // the arrivals hook failed
+} simulation_status_t;
+
+/**
+  Above this many cores the busy cores are kept in a heap by their next
+  event; below it, scanning every core's next event is cheaper.
+*/
+#define SIMULATION_HEAP_CORES 64
+
+/**
+  A busy core's place in the event heap: the time its job finishes, its
+  quantum expires or its switch stall ends, whichever comes first.
+*/
+typedef struct _simulation_core_event_t
+{
+	int core_id;
+	int time;
+	int queued; // in the heap; idle cores are not
+	priqueue_handle_t handle;
+} simulation_core_event_t;
+
+struct _simulation_t;
+
+/**
+  Calls a simulation makes as it runs, so a front end can log events,
+  draw the timing diagram or stream arrivals in. Any may be NULL.
+*/
+typedef struct _simulation_hooks_t
+{
+	// a step begins at sim->time, before any event of that time
+	void (*step)(struct _simulation_t *sim);
+	// job_id finished (or had its quantum expire) on core_id, which now runs new_job_id
+	void (*finished)(struct _simulation_t *sim, int job_id, int core_id, int new_job_id);
+	void (*expired)(struct _simulation_t *sim, int job_id, int core_id, int new_job_id);
+	// job arrived and was put on core_id, or queued if core_id is -1
+	void (*arrived)(struct _simulation_t *sim, const simulation_job_t *job, int core_id);
+	// every core ran span units from sim->time; running[] still shows on what
+	void (*ran)(struct _simulation_t *sim, int span);
+	// the arrival list must hold every job arriving at sim->time and the next one after; returns -1 on failure
+	int (*arrivals)(struct _simulation_t *sim);
+	void *arg;
+} simulation_hooks_t;
+
+/**
+  One run of a trace through a scheduler context. The arrival list
+  (trace, trace_count, next_arrival) belongs to the caller; a streaming
+  caller refills it from the arrivals hook.
+*/
+typedef struct _simulation_t
+{
+	scheduler_ctx_t *ctx;
+	int cores;
+	scheme_t scheme;
+	int quantum; // RR quantum
+	int event_driven; // run up to the next event at once instead of one unit at a time
+	int count_switches; // stall cores for switch_cost (and migration_cost) when they change jobs
+	int switch_cost;
+	int migration_cost;
+	simulation_hooks_t hooks;
+
+	simulation_job_t *trace; // jobs in arrival order
+	int trace_count;
+	int next_arrival;
+
+	int time;
+	long events; // scheduler calls made
+	int bad_value;
+
+	// jobs that arrived and have not finished, and the index of the one on each core
+	simulation_job_t *jobs;
+	int active_jobs, jobs_capacity;
+	int *running;
+
+	// job id -> index in jobs (-1 once finished), from slot_base up to the last id that arrived
+	int *slot;
+	int slot_base, known_jobs, slot_capacity;
+
+	// legacy order of simultaneous events (see simulation_init()), NULL if unused
+	int *order, *order_position;
+	int order_count;
+
+	int *quantum_clock;
+	int uses_quantum;
+
+	/*
+	 * Busy cores by their next event. A core's counters (its job's run_time,
+	 * quantum_clock, stall and overhead) are only brought up to date, from
+	 * the time in since[], when the core has an event or the step changes it,
+	 * so a step costs O(log cores) per changed core rather than O(cores).
+	 */
+	priqueue_t next_events; // unused up to SIMULATION_HEAP_CORES cores
+	simulation_core_event_t *core_events;
+	int *since;
+	int use_heap, busy_cores;
+
+	// cores changed in the current step, and a flag per core
+	int *changed, changed_count;
+	int *is_changed;
+
+	// job each core ran last, time left of the switch it is paying for and its counters
+	int *last_job;
+	int *stall;
+	unsigned long *switches;
+	unsigned long *migrations;
+	long long *overhead;
+} simulation_t;
+
+
+void  simulation_init          (simulation_t *sim, scheduler_ctx_t *ctx, int cores, scheme_t scheme, int quantum,
+                                simulation_job_t *trace, int trace_count, int report_order);
+simulation_status_t simulation_run(simulation_t *sim);
+void  simulation_destroy       (simulation_t *sim);
+int   simulation_compare_arrival(const void *a, const void *b);
+
+#endif /* LIBSIMULATION_H_ */
@@ -0,0 +1,324 @@
+/** @file libtrace.c
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "libtrace.h"
+
+/*
+ * Gives back the pages of the mapping before the cursor once another
+ * TRACE_RELEASE_BYTES have been parsed. They count towards the resident
+ * set until then, however long ago they were read.
+ */
+static void release_parsed(trace_t *t)
+{
+	if (t->offset - t->released < TRACE_RELEASE_BYTES)
+		return;
+
+	size_t page = sysconf(_SC_PAGESIZE);
+	size_t end = t->offset / page * page;
+	madvise((void *)(t->data + t->released), end - t->released, MADV_DONTNEED);
+	t->released = end;
+}
+
+
+/**
+  Validates the header and checksum of a binary trace and points the
+  reader at its records, which are used in place from the mapping. Both
+  the current version and version 1, which had no deadlines, are read.
+
+  @return 0 on success
+  @return -2 if the trace is truncated, of another version or corrupt
+ */
+static int open_binary(trace_t *t)
+{
+	trace_header_t header;
+	size_t record_size;
+
+	if (t->length < sizeof(trace_header_t))
+		return -2;
+	memcpy(&header, t->data, sizeof(trace_header_t));
+
+	if (header.version == TRACE_VERSION)
+		record_size = sizeof(trace_record_t);
+	else if (header.version == TRACE_VERSION_NO_DEADLINES)
+		record_size = sizeof(trace_record_v1_t);
+	else
+		return -2;
+	if (header.record_size != record_size)
+		return -2;
+	if ((t->length - sizeof(trace_header_t)) % record_size != 0 ||
+			header.count != (t->length - sizeof(trace_header_t)) / record_size)
+		return -2;
+
+	t->binary = 1;
+	t->flags = header.flags;
+	t->version = header.version;
+	t->count = header.count;
+	t->records = t->data + sizeof(trace_header_t);
+	t->offset = sizeof(trace_header_t);
+
+	// Hash a step at a time, giving each back, so checking a trace does not keep all of it resident
+	uint64_t hash = TRACE_CHECKSUM_SEED;
+	size_t length = header.count * record_size, done, step;
+	for (done = 0; done < length; done += step)
+	{
+		step = length - done < TRACE_RELEASE_BYTES ? length - done : TRACE_RELEASE_BYTES;
+		hash = trace_checksum_update(hash, (const char *)t->records + done, step);
+		t->offset += step;
+		release_parsed(t);
+	}
+	t->offset = sizeof(trace_header_t);
+	t->released = 0;
+
+	if (hash != header.checksum)
+		return -2;
+
+	return 0;
+}
+
+
+/**
+  Maps a job trace into memory. Binary traces (see trace_header_t) are
+  validated and read in place; CSV traces are positioned after their
+  header line. The mapping is read sequentially, so the kernel can read
+  ahead, and pages behind the cursor are given back as it moves on (see
+  release_parsed()), so streaming a trace of any size keeps few of them.
+
+  @param t a pointer to an instance of the trace_t data structure
+  @param file_name path of the trace
+  @return 0 on success
+  @return -1 if the file cannot be opened or mapped
+  @return -2 if the file is a damaged or incompatible binary trace
+ */
+int trace_open(trace_t *t, const char *file_name)
+{
+	struct stat st;
+	int fd = open(file_name, O_RDONLY);
+
+	if (fd < 0)
+		return -1;
+	if (fstat(fd, &st) < 0)
+	{
+		close(fd);
+		return -1;
+	}
+
+	t->data = NULL;
+	t->length = st.st_size;
+	t->offset = 0;
+	t->jobs = 0;
+	t->binary = 0;
+	t->flags = 0;
+	t->version = 0;
+	t->records = NULL;
+	t->count = 0;
+	t->released = 0;
+
+	if (t->length > 0)
+	{
+		void *map = mmap(NULL, t->length, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (map == MAP_FAILED)
+		{
+			close(fd);
+			return -1;
+		}
+		madvise(map, t->length, MADV_SEQUENTIAL);
+		t->data = map;
+	}
+	close(fd);
+
+	if (t->length >= sizeof(TRACE_MAGIC) - 1 && memcmp(t->data, TRACE_MAGIC, sizeof(TRACE_MAGIC) - 1) == 0)
+	{
+		int status = open_binary(t);
+		if (status != 0)
+			trace_close(t);
+		return status;
+	}
+
+	// Ignore the first (header) line
+	while (t->offset < t->length && t->data[t->offset++] != '\n')
+		;
+
+	return 0;
+}
+
+
+/**
+  Parses the next job of the trace.
+
+  Binary records are copied out as is; version 1 records get a deadline
+  of -1. CSV fields are read like atoi(): leading blanks and a sign are accepted and
+  parsing stops at the first non-digit. Blank lines are skipped. An
+  optional fourth column holds the deadline; a job without one (or with
+  an empty one) gets -1. Columns after the fourth are ignored.
+
+  @param t a pointer to an instance of the trace_t data structure
+  @param job receives the parsed job
+  @return 1 if a job was read
+  @return 0 at the end of the trace
+  @return -1 if the line does not have three fields
+ */
+int trace_next(trace_t *t, trace_job_t *job)
+{
+	const char *p = t->data + t->offset;
+	const char *end = t->data + t->length;
+	int fields[4];
+	int n, deadline_digits = 0;
+
+	if (t->binary)
+	{
+		if ((uint64_t)t->jobs == t->count)
+			return 0;
+
+		if (t->version == TRACE_VERSION_NO_DEADLINES)
+		{
+			const trace_record_v1_t *record = (const trace_record_v1_t *)t->records + t->jobs++;
+			job->arrival_time = record->arrival_time;
+			job->run_time = record->run_time;
+			job->priority = record->priority;
+			job->deadline = -1;
+			t->offset += sizeof(trace_record_v1_t);
+			release_parsed(t);
+			return 1;
+		}
+
+		const trace_record_t *record = (const trace_record_t *)t->records + t->jobs++;
+		job->arrival_time = record->arrival_time;
+		job->run_time = record->run_time;
+		job->priority = record->priority;
+		job->deadline = record->deadline;
+		t->offset += sizeof(trace_record_t);
+		release_parsed(t);
+		return 1;
+	}
+
+	while (p < end && (*p == '\n' || *p == '\r'))
+		p++;
+	if (p == end)
+	{
+		t->offset = t->length;
+		return 0;
+	}
+
+	for (n = 0; n < 4; n++)
+	{
+		if (n > 0)
+		{
+			if (p == end || *p != ',')
+				break;
+			p++;
+		}
+
+		while (p < end && (*p == ' ' || *p == '\t'))
+			p++;
+
+		int negative = 0, value = 0;
+		if (p < end && (*p == '-' || *p == '+'))
+			negative = (*p++ == '-');
+		while (p < end && *p >= '0' && *p <= '9')
+		{
+			value = value * 10 + (*p++ - '0');
+			if (n == 3)
+				deadline_digits++;
+		}
+		fields[n] = negative ? -value : value;
+
+		while (p < end && *p != ',' && *p != '\n')
+			p++;
+	}
+
+	while (p < end && *p != '\n')
+		p++;
+	if (p < end)
+		p++;
+	t->offset = p - t->data;
+
+	if (n < 3)
+		return -1;
+
+	job->arrival_time = fields[0];
+	job->run_time = fields[1];
+	job->priority = fields[2];
+	job->deadline = (n == 4 && deadline_digits > 0) ? fields[3] : -1;
+	t->jobs++;
+	release_parsed(t);
+	return 1;
+}
+
+
+/**
+  Prints the parse throughput of t to stderr.
+
+  @param t a pointer to an instance of the trace_t data structure
+  @param what verb describing how the trace was consumed
+  @param seconds time spent parsing
+ */
+void trace_report(trace_t *t, const char *what, double seconds)
+{
+	double mb = t->offset / (1024.0 * 1024.0);
+
+	if (seconds <= 0.0)
+		seconds = 1e-9;
+
+	fprintf(stderr, "%s %ld job(s), %.2f MB in %.3f s (%.1f MB/s, %.0f jobs/s)\n",
+			what, t->jobs, mb, seconds, mb / seconds, t->jobs / seconds);
+}
+
+
+/**
+  Computes the 64-bit FNV-1a hash used to validate binary traces.
+
+  @param data bytes to hash
+  @param length number of bytes
+  @return the hash of data
+ */
+uint64_t trace_checksum(const void *data, size_t length)
+{
+	return trace_checksum_update(TRACE_CHECKSUM_SEED, data, length);
+}
+
+
+/**
+  Continues an FNV-1a hash over more bytes, so a trace can be hashed
+  while it is written a record at a time.
+
+  @param hash the hash so far (TRACE_CHECKSUM_SEED for no bytes)
+  @param data bytes to hash
+  @param length number of bytes
+  @return the hash of the bytes seen so far followed by data
+ */
+uint64_t trace_checksum_update(uint64_t hash, const void *data, size_t length)
+{
+	const unsigned char *p = data;
+
+	for (size_t i = 0; i < length; i++)
+	{
+		hash ^= p[i];
+		hash *= 1099511628211ULL;
+	}
+	return hash;
+}
+
+
+/**
+  Unmaps the trace.
+
+  @param t a pointer to an instance of the trace_t data structure
+ */
+void trace_close(trace_t *t)
+{
+	if (t->data != NULL)
+		munmap((void *)t->data, t->length);
+
+	t->data = NULL;
+	t->length = 0;
+	t->offset = 0;
+	t->records = NULL;
+}
@@ -0,0 +1,93 @@
+/** @file libtrace.h
+ */
+
+#ifndef LIBTRACE_H_
+#define LIBTRACE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+  One job record of an input trace.
+*/
+typedef struct _trace_job_t
+{
+  int arrival_time;
+  int run_time;
+  int priority;
+  int deadline; // time the job should finish by, -1 if it has none
+} trace_job_t;
+
+#define TRACE_MAGIC "SCHTRACE"
+#define TRACE_VERSION 2
+#define TRACE_VERSION_NO_DEADLINES 1
+#define TRACE_SORTED 0x1
+#define TRACE_CHECKSUM_SEED 14695981039346656037ULL
+#define TRACE_RELEASE_BYTES (1 << 20) // parsed bytes dropped from the mapping at a time
+
+/**
+  Header of a binary trace. It is followed by count fixed-width records
+  in host byte order; checksum is the FNV-1a hash of the record bytes.
+*/
+typedef struct _trace_header_t
+{
+  char magic[8];
+  uint32_t version;
+  uint32_t record_size;
+  uint64_t count;
+  uint32_t flags;
+  uint32_t reserved;
+  uint64_t checksum;
+} trace_header_t;
+
+/**
+  Packed job record of a binary trace.
+*/
+typedef struct _trace_record_t
+{
+  int32_t arrival_time;
+  int32_t run_time;
+  int32_t priority;
+  int32_t deadline;
+} trace_record_t;
+
+/**
+  Job record of a version 1 binary trace, written before jobs had
+  deadlines. Its jobs are read with a deadline of -1.
+*/
+typedef struct _trace_record_v1_t
+{
+  int32_t arrival_time;
+  int32_t run_time;
+  int32_t priority;
+} trace_record_v1_t;
+
+/**
+  Reader over a memory-mapped job trace, either CSV text or binary.
+*/
+typedef struct _trace_t
+{
+  const char *data;
+  size_t length;
+  size_t offset;
+  long jobs;
+
+  int binary;
+  uint32_t flags;
+  uint32_t version;
+  const void *records;
+  uint64_t count;
+
+  size_t released; // bytes at the start of the mapping already given back
+} trace_t;
+
+
+int   trace_open        (trace_t *t, const char *file_name);
+int   trace_next        (trace_t *t, trace_job_t *job);
+void  trace_report      (trace_t *t, const char *what, double seconds);
+void  trace_close       (trace_t *t);
+
+uint64_t trace_checksum (const void *data, size_t length);
+uint64_t trace_checksum_update(uint64_t hash, const void *data, size_t length);
+
+#endif /* LIBTRACE_H_ */
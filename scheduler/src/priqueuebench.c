@@ -0,0 +1,428 @@
+/** @file priqueuebench.c
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <getopt.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+
+#include "libpriqueue/libpriqueue.h"
+#include "libpriqueue/libpriqueue_heap.h"
+
+#define BENCH_MAX_OPS 1000000 // timed operations per run, whatever the queue size
+#define BENCH_MIN_OPS 1000
+#define BENCH_MAX_NS 2000000000L // stop early once this much time was spent in operations
+#define BENCH_BURST 16
+#define BENCH_SAMPLE_EVERY 64 // operations per one timed on its own for the latency percentiles
+
+/**
+  Element stored in the queues: the scheduling key the comparers look at.
+*/
+typedef struct _bench_item_t
+{
+	int key;
+	priqueue_handle_t handle;
+} bench_item_t;
+
+typedef struct _bench_backend_t
+{
+	const char *name;
+	priqueue_backend_t backend;
+	int specialized; // heap with the comparer compiled into its sift routines
+} bench_backend_t;
+
+/**
+  Measurements of one run, written to the parent through a pipe.
+*/
+typedef struct _bench_result_t
+{
+	long ops;
+	double ns_per_op;
+	double comparisons_per_s; // -1 when the backend compares packed keys rather than calling the comparer
+	long p50_ns;
+	long p99_ns;
+	unsigned long allocations;
+	long peak_rss_kb;
+} bench_result_t;
+
+static const bench_backend_t backends[] =
+{
+	{ "list", PRIQUEUE_LIST, 0 },
+	{ "heap", PRIQUEUE_HEAP, 0 },
+	{ "heap-inline", PRIQUEUE_HEAP, 1 },
+	{ "keyed", PRIQUEUE_KEYED, 0 },
+	{ "rbtree", PRIQUEUE_RBTREE, 0 },
+};
+#define NUM_BACKENDS (int)(sizeof(backends) / sizeof(backends[0]))
+
+static const char *workloads[] = { "rr", "sjf", "ppri", "remove", "handle", "update" };
+#define NUM_WORKLOADS (int)(sizeof(workloads) / sizeof(workloads[0]))
+
+static unsigned long long rng_state = 88172645463325252ULL;
+static unsigned long comparisons;
+
+/*
+ * xorshift64, so every run sees the same sequence of keys.
+ */
+static unsigned int next_random()
+{
+	rng_state ^= rng_state << 13;
+	rng_state ^= rng_state >> 7;
+	rng_state ^= rng_state << 17;
+	return rng_state >> 33;
+}
+
+static long now_ns()
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return now.tv_sec * 1000000000L + now.tv_nsec;
+}
+
+int compare_key(const void *a, const void *b)
+{
+	comparisons++;
+	return ((const bench_item_t *)a)->key - ((const bench_item_t *)b)->key;
+}
+
+// Round robin: every job compares equal, so the queue behaves as a FIFO
+int compare_equal(const void *a, const void *b)
+{
+	comparisons++;
+	return 0;
+}
+
+unsigned long long key_of(const void *a)
+{
+	return ((const bench_item_t *)a)->key;
+}
+
+unsigned long long key_equal(const void *a)
+{
+	return 0;
+}
+
+PRIQUEUE_HEAP_SPECIALIZE(key, compare_key);
+PRIQUEUE_HEAP_SPECIALIZE(equal, compare_equal);
+
+int compare_long(const void *a, const void *b)
+{
+	long x = *(const long *)a, y = *(const long *)b;
+	return (x > y) - (x < y);
+}
+
+void print_usage(char *program_name)
+{
+	fprintf(stderr, "Usage: %s [-b backends] [-w workloads] [-n sizes] [-l max list size] [-o output]\n", program_name);
+	fprintf(stderr, "       %s -b heap -w sjf,ppri -n 1000,1000000\n", program_name);
+	fprintf(stderr, "\n");
+	fprintf(stderr, "Backends are: list, heap, heap-inline, keyed, rbtree (default: all of them).\n");
+	fprintf(stderr, "  heap-inline  the heap with the comparer compiled into it\n");
+	fprintf(stderr, "  keyed        8-ary heap of packed 64-bit keys\n");
+	fprintf(stderr, "  rbtree       red-black tree\n");
+	fprintf(stderr, "Workloads are:\n");
+	fprintf(stderr, "  rr      poll the head and offer it back with equal keys (FIFO churn)\n");
+	fprintf(stderr, "  sjf     poll the smallest key and offer a random one\n");
+	fprintf(stderr, "  ppri    bursts of %d offers that beat every queued key, then %d polls\n", BENCH_BURST, BENCH_BURST);
+	fprintf(stderr, "  remove  remove a random queued element and offer it back\n");
+	fprintf(stderr, "  handle  the same through priqueue_remove_handle() and priqueue_offer_handle()\n");
+	fprintf(stderr, "  update  lower the key of a random queued element and priqueue_update_key() it\n");
+	fprintf(stderr, "Sizes default to 10^3 through 10^7; the list backend is skipped above -l (default 10000).\n");
+	fprintf(stderr, "Each run prefills the queue to its size and times up to %d operations (fewer once they\n", BENCH_MAX_OPS);
+	fprintf(stderr, "took %.0f s), in a child process so its peak RSS is its own. Results are written as CSV.\n", BENCH_MAX_NS / 1e9);
+	fprintf(stderr, "ns_per_op is the time of the whole run per operation; p50_ns and p99_ns come from every\n");
+	fprintf(stderr, "%dth operation, timed on its own.\n", BENCH_SAMPLE_EVERY);
+	fprintf(stderr, "comparisons_per_s is n/a for keyed, which compares packed keys without calling the comparer.\n");
+}
+
+/*
+ * Runs one workload on a queue prefilled with size items and fills result.
+ * The throughput columns come from the time of the whole loop; only every
+ * BENCH_SAMPLE_EVERY-th priqueue call is timed on its own, for the latency
+ * percentiles, so the clock reads add little to ns_per_op.
+ */
+void run_workload(const bench_backend_t *backend, const char *workload, int size, bench_result_t *result)
+{
+	priqueue_t q;
+	int rr = strcmp(workload, "rr") == 0;
+	int handles = strcmp(workload, "handle") == 0 || strcmp(workload, "update") == 0;
+	int total = size + BENCH_BURST;
+	long max_ops = BENCH_MAX_OPS;
+	long ops = 0, num_samples = 0, i;
+
+	bench_item_t *items = malloc(total * sizeof(bench_item_t));
+	long *samples = malloc((max_ops / BENCH_SAMPLE_EVERY + 1) * sizeof(long));
+
+	if (backend->backend == PRIQUEUE_KEYED)
+		priqueue_init_keyed(&q, rr ? key_equal : key_of);
+	else if (backend->specialized)
+		priqueue_init_heap_ops(&q, rr ? compare_equal : compare_key, rr ? &equal_heap_ops : &key_heap_ops);
+	else
+		priqueue_init_backend(&q, rr ? compare_equal : compare_key, backend->backend);
+
+	for (i = 0; i < size; i++)
+	{
+		items[i].key = next_random() % (1 << 30) + (1 << 20);
+		if (handles)
+			priqueue_offer_handle(&q, &items[i], &items[i].handle);
+		else
+			priqueue_offer(&q, &items[i]);
+	}
+
+	unsigned long hits, prefill_misses, misses;
+	priqueue_pool_stats(&q, &hits, &prefill_misses);
+
+	comparisons = 0;
+	long start = now_ns();
+
+#define TIMED(call) \
+	do { \
+		if (ops % BENCH_SAMPLE_EVERY == 0) \
+		{ \
+			long call_start = now_ns(); \
+			call; \
+			long call_end = now_ns(); \
+			samples[num_samples++] = call_end - call_start; \
+			if (ops >= BENCH_MIN_OPS && call_end - start > BENCH_MAX_NS) \
+				max_ops = ops + 1; \
+		} \
+		else \
+			call; \
+		ops++; \
+	} while (0)
+
+	if (rr || strcmp(workload, "sjf") == 0)
+	{
+		while (ops < max_ops)
+		{
+			bench_item_t *item;
+			TIMED(item = priqueue_poll(&q));
+			if (!rr)
+				item->key = next_random() % (1 << 30) + (1 << 20);
+			TIMED(priqueue_offer(&q, item));
+		}
+	}
+	else if (strcmp(workload, "ppri") == 0)
+	{
+		int next_key = (1 << 20);
+
+		while (ops + 2 * BENCH_BURST <= max_ops)
+		{
+			for (i = 0; i < BENCH_BURST; i++)
+			{
+				items[size + i].key = --next_key;
+				TIMED(priqueue_offer(&q, &items[size + i]));
+			}
+			for (i = 0; i < BENCH_BURST; i++)
+				TIMED(priqueue_poll(&q));
+		}
+	}
+	else if (strcmp(workload, "remove") == 0)
+	{
+		while (ops < max_ops)
+		{
+			bench_item_t *item = &items[next_random() % size];
+			TIMED(priqueue_remove(&q, item));
+			TIMED(priqueue_offer(&q, item));
+		}
+	}
+	else if (strcmp(workload, "handle") == 0)
+	{
+		while (ops < max_ops)
+		{
+			bench_item_t *item = &items[next_random() % size];
+			TIMED(priqueue_remove_handle(&q, item->handle));
+			TIMED(priqueue_offer_handle(&q, item, &item->handle));
+		}
+	}
+	else
+	{
+		// Decrease-key, as when a queued job's remaining time shrinks
+		while (ops < max_ops)
+		{
+			bench_item_t *item = &items[next_random() % size];
+			item->key -= item->key / 8;
+			TIMED(priqueue_update_key(&q, item->handle));
+		}
+	}
+#undef TIMED
+
+	long elapsed = now_ns() - start;
+
+	priqueue_pool_stats(&q, &hits, &misses);
+	priqueue_destroy(&q);
+
+	qsort(samples, num_samples, sizeof(long), compare_long);
+
+	struct rusage usage;
+	getrusage(RUSAGE_SELF, &usage);
+
+	result->ops = ops;
+	result->ns_per_op = (double)elapsed / ops;
+	result->comparisons_per_s = backend->backend == PRIQUEUE_KEYED ? -1 : comparisons * 1e9 / elapsed;
+	result->p50_ns = samples[num_samples / 2];
+	result->p99_ns = samples[num_samples * 99 / 100];
+	result->allocations = misses - prefill_misses;
+	result->peak_rss_kb = usage.ru_maxrss;
+
+	free(samples);
+	free(items);
+}
+
+/*
+ * Parses a comma separated list of names against a table of choices and
+ * sets selected[i] for each one. Returns -1 on an unknown name.
+ */
+int parse_names(char *list, const char **names, int count, int *selected)
+{
+	char *saveptr, *name;
+	int i;
+
+	memset(selected, 0, count * sizeof(int));
+	for (name = strtok_r(list, ",", &saveptr); name != NULL; name = strtok_r(NULL, ",", &saveptr))
+	{
+		for (i = 0; i < count && strcmp(name, names[i]) != 0; i++)
+			;
+		if (i == count)
+			return -1;
+		selected[i] = 1;
+	}
+	return 0;
+}
+
+
+int main(int argc, char **argv)
+{
+	int c, b, w, n, i;
+	int sizes[32] = { 1000, 10000, 100000, 1000000, 10000000 }, num_sizes = 5;
+	int max_list_size = 10000;
+	int use_backend[NUM_BACKENDS] = { 1, 1, 1, 1, 1 }, use_workload[NUM_WORKLOADS] = { 1, 1, 1, 1, 1, 1 };
+	const char *backend_names[NUM_BACKENDS] = { backends[0].name, backends[1].name, backends[2].name, backends[3].name, backends[4].name };
+	FILE *output = stdout;
+
+	while ((c = getopt(argc, argv, "b:w:n:l:o:")) != -1)
+	{
+		switch (c)
+		{
+			case 'b':
+				if (parse_names(optarg, backend_names, NUM_BACKENDS, use_backend) != 0)
+				{
+					fprintf(stderr, "Unknown backend in \"%s\".\n", optarg);
+					print_usage(argv[0]);
+					return 1;
+				}
+				break;
+
+			case 'w':
+				if (parse_names(optarg, workloads, NUM_WORKLOADS, use_workload) != 0)
+				{
+					fprintf(stderr, "Unknown workload in \"%s\".\n", optarg);
+					print_usage(argv[0]);
+					return 1;
+				}
+				break;
+
+			case 'n':
+			{
+				char *saveptr, *size;
+				num_sizes = 0;
+				for (size = strtok_r(optarg, ",", &saveptr); size != NULL && num_sizes < 32; size = strtok_r(NULL, ",", &saveptr))
+				{
+					if ((sizes[num_sizes++] = atoi(size)) <= 0)
+					{
+						fprintf(stderr, "Option -n requires a list of positive sizes. (Eg: -n 1000,100000)\n");
+						print_usage(argv[0]);
+						return 1;
+					}
+				}
+				break;
+			}
+
+			case 'l':
+				max_list_size = atoi(optarg);
+				break;
+
+			case 'o':
+				if ((output = fopen(optarg, "w")) == NULL)
+				{
+					fprintf(stderr, "Unable to create \"%s\".\n", optarg);
+					return 2;
+				}
+				break;
+
+			default:
+				print_usage(argv[0]);
+				return 1;
+		}
+	}
+
+	fprintf(output, "backend,workload,size,ops,ns_per_op,p50_ns,p99_ns,allocations,peak_rss_kb,comparisons_per_s\n");
+	fflush(output);
+
+	for (w = 0; w < NUM_WORKLOADS; w++)
+	{
+		for (n = 0; n < num_sizes; n++)
+		{
+			for (b = 0; b < NUM_BACKENDS; b++)
+			{
+				if (!use_workload[w] || !use_backend[b])
+					continue;
+
+				if (backends[b].backend == PRIQUEUE_LIST && sizes[n] > max_list_size)
+				{
+					fprintf(stderr, "Skipping %s/%s at %d: above the list size limit (-l).\n", backends[b].name, workloads[w], sizes[n]);
+					continue;
+				}
+
+				/*
+				 * Run in a child so peak RSS covers this run only.
+				 */
+				bench_result_t result;
+				int fds[2];
+
+				if (pipe(fds) != 0)
+				{
+					perror("pipe");
+					return 2;
+				}
+
+				pid_t pid = fork();
+				if (pid == 0)
+				{
+					close(fds[0]);
+					run_workload(&backends[b], workloads[w], sizes[n], &result);
+					i = write(fds[1], &result, sizeof(result));
+					_exit(i == sizeof(result) ? 0 : 1);
+				}
+
+				close(fds[1]);
+				i = read(fds[0], &result, sizeof(result));
+				close(fds[0]);
+				waitpid(pid, NULL, 0);
+
+				if (i != sizeof(result))
+				{
+					fprintf(stderr, "Run %s/%s at %d failed.\n", backends[b].name, workloads[w], sizes[n]);
+					continue;
+				}
+
+				fprintf(output, "%s,%s,%d,%ld,%.1f,%ld,%ld,%lu,%ld,", backends[b].name, workloads[w], sizes[n],
+						result.ops, result.ns_per_op, result.p50_ns, result.p99_ns, result.allocations, result.peak_rss_kb);
+				if (result.comparisons_per_s < 0)
+					fprintf(output, "n/a\n");
+				else
+					fprintf(output, "%.0f\n", result.comparisons_per_s);
+				fflush(output);
+			}
+		}
+	}
+
+	if (output != stdout)
+		fclose(output);
+
+	return 0;
+}
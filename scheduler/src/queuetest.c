@@ -1,74 +1,200 @@
-/** @file queuetest.c
- */
-
-#include <stdio.h>
-#include <stdlib.h>
-
-#include "libpriqueue/libpriqueue.h"
-
-int compare1(const void * a, const void * b)
-{
-	return ( *(int*)a - *(int*)b );
-}
-
-int compare2(const void * a, const void * b)
-{
-	return ( *(int*)b - *(int*)a );
-}
-
-int main()
-{
-	priqueue_t q, q2;
-
-	priqueue_init(&q, compare1);
-	priqueue_init(&q2, compare2);
-
-	/* Pupulate some data... */
-	int *values = malloc(100 * sizeof(int));
-
-	int i;
-	for (i = 0; i < 100; i++)
-		values[i] = i;
-
-	/* Add 5 values, 3 unique. */
-	priqueue_offer(&q, &values[12]);
-	priqueue_offer(&q, &values[13]);
-	priqueue_offer(&q, &values[14]);
-	priqueue_offer(&q, &values[12]);
-	priqueue_offer(&q, &values[12]);
-	printf("Total elements: %d (expected 5).\n", priqueue_size(&q));
-
-	int val = *((int *)priqueue_poll(&q));
-	printf("Top element: %d (expected 12).\n", val);
-	printf("Total elements: %d (expected 4).\n", priqueue_size(&q));
-
-	int vals_removed = priqueue_remove(&q, &values[12]);
-	printf("Elements removed: %d (expected 2).\n", vals_removed);
-	printf("Total elements: %d (expected 2).\n", priqueue_size(&q));
-
-	priqueue_offer(&q, &values[10]);
-	priqueue_offer(&q, &values[30]);
-	priqueue_offer(&q, &values[20]);
-
-	priqueue_offer(&q2, &values[10]);
-	priqueue_offer(&q2, &values[30]);
-	priqueue_offer(&q2, &values[20]);
-
-
-	printf("Elements in order queue (expected 10 13 14 20 30): ");
-	for (i = 0; i < priqueue_size(&q); i++)
-		printf("%d ", *((int *)priqueue_at(&q, i)) );
-	printf("\n");
-
-	printf("Elements in reverse order queue (expected 30 20 10): ");
-	for (i = 0; i < priqueue_size(&q2); i++)
-		printf("%d ", *((int *)priqueue_at(&q2, i)) );
-	printf("\n");
-
-	priqueue_destroy(&q2);
-	priqueue_destroy(&q);
-
-	free(values);
-
-	return 0;
-}
+/** @file queuetest.c
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "libpriqueue/libpriqueue.h"
+
+int compare1(const void * a, const void * b)
+{
+	return ( *(int*)a - *(int*)b );
+}
+
+int compare2(const void * a, const void * b)
+{
+	return ( *(int*)b - *(int*)a );
+}
+
+int compare_tens(const void * a, const void * b)
+{
+	return ( *(int*)a / 10 - *(int*)b / 10 );
+}
+
+void test_backend(priqueue_backend_t backend, const char *name)
+{
+	priqueue_t q, q2;
+
+	printf("=== %s backend ===\n", name);
+	priqueue_init_backend(&q, compare1, backend);
+	priqueue_init_backend(&q2, compare2, backend);
+
+	/* Pupulate some data... */
+	int *values = malloc(100 * sizeof(int));
+
+	int i;
+	for (i = 0; i < 100; i++)
+		values[i] = i;
+
+	/* Add 5 values, 3 unique. */
+	priqueue_offer(&q, &values[12]);
+	priqueue_offer(&q, &values[13]);
+	priqueue_offer(&q, &values[14]);
+	priqueue_offer(&q, &values[12]);
+	priqueue_offer(&q, &values[12]);
+	printf("Total elements: %d (expected 5).\n", priqueue_size(&q));
+
+	int val = *((int *)priqueue_poll(&q));
+	printf("Top element: %d (expected 12).\n", val);
+	printf("Total elements: %d (expected 4).\n", priqueue_size(&q));
+
+	int vals_removed = priqueue_remove(&q, &values[12]);
+	printf("Elements removed: %d (expected 2).\n", vals_removed);
+	printf("Total elements: %d (expected 2).\n", priqueue_size(&q));
+
+	priqueue_offer(&q, &values[10]);
+	priqueue_offer(&q, &values[30]);
+	priqueue_offer(&q, &values[20]);
+
+	priqueue_offer(&q2, &values[10]);
+	priqueue_offer(&q2, &values[30]);
+	priqueue_offer(&q2, &values[20]);
+
+
+	printf("Elements in order queue (expected 10 13 14 20 30): ");
+	for (i = 0; i < priqueue_size(&q); i++)
+		printf("%d ", *((int *)priqueue_at(&q, i)) );
+	printf("\n");
+
+	printf("Elements in reverse order queue (expected 30 20 10): ");
+	for (i = 0; i < priqueue_size(&q2); i++)
+		printf("%d ", *((int *)priqueue_at(&q2, i)) );
+	printf("\n");
+
+	priqueue_destroy(&q2);
+	priqueue_destroy(&q);
+
+	/* Elements the comparer considers equal must come out in FIFO order. */
+	priqueue_t q3;
+	priqueue_init_backend(&q3, compare_tens, backend);
+	priqueue_offer(&q3, &values[21]);
+	priqueue_offer(&q3, &values[15]);
+	priqueue_offer(&q3, &values[29]);
+	priqueue_offer(&q3, &values[11]);
+	priqueue_offer(&q3, &values[20]);
+	priqueue_offer(&q3, &values[3]);
+
+	printf("Elements in FIFO tie order (expected 3 15 11 21 29 20): ");
+	while (priqueue_size(&q3) > 0)
+		printf("%d ", *((int *)priqueue_poll(&q3)) );
+	printf("\n");
+
+	priqueue_offer(&q3, &values[21]);
+	priqueue_offer(&q3, &values[15]);
+	priqueue_offer(&q3, &values[29]);
+	priqueue_offer(&q3, &values[11]);
+	printf("Removed at index 1: %d (expected 11).\n", *((int *)priqueue_remove_at(&q3, 1)) );
+	printf("Elements after remove_at (expected 15 21 29): ");
+	for (i = 0; i < priqueue_size(&q3); i++)
+		printf("%d ", *((int *)priqueue_at(&q3, i)) );
+	printf("\n");
+
+	/* Once warmed up, offer/poll churn must be served from the pool. */
+	unsigned long hits, misses, warm_misses;
+	priqueue_pool_stats(&q3, NULL, &warm_misses);
+	for (i = 0; i < 1000; i++)
+	{
+		priqueue_offer(&q3, &values[i % 100]);
+		priqueue_poll(&q3);
+	}
+	priqueue_pool_stats(&q3, &hits, &misses);
+	printf("Pool misses during churn: %lu (expected 0).\n", misses - warm_misses);
+	printf("\n");
+
+	priqueue_destroy(&q3);
+
+	/* Handles remove and reposition specific elements without searching. */
+	priqueue_t q4;
+	priqueue_handle_t handles[5];
+	int keys[5] = { 50, 40, 30, 20, 10 };
+	priqueue_init_backend(&q4, compare1, backend);
+	for (i = 0; i < 5; i++)
+		priqueue_offer_handle(&q4, &keys[i], &handles[i]);
+	priqueue_pool_stats(&q4, &hits, &misses);
+	printf("Pool hits and misses for 5 handle offers: %lu (expected 5).\n", hits + misses);
+
+	printf("Removed by handle: %d (expected 30).\n", *((int *)priqueue_remove_handle(&q4, handles[2])) );
+	keys[0] = 5;
+	priqueue_update_key(&q4, handles[0]);
+	keys[4] = 45;
+	priqueue_update_key(&q4, handles[4]);
+	printf("Elements after update_key (expected 5 20 40 45): ");
+	for (i = 0; i < priqueue_size(&q4); i++)
+		printf("%d ", *((int *)priqueue_at(&q4, i)) );
+	printf("\n");
+
+	priqueue_remove_handle(&q4, handles[3]);
+	printf("Elements after removing 20 by handle (expected 5 40 45): ");
+	while (priqueue_size(&q4) > 0)
+		printf("%d ", *((int *)priqueue_poll(&q4)) );
+	printf("\n");
+
+	priqueue_destroy(&q4);
+
+	free(values);
+}
+
+unsigned long long key_tens(const void * a)
+{
+	return *(int*)a / 10;
+}
+
+void test_keyed()
+{
+	priqueue_t q;
+	int i, values[100];
+	priqueue_handle_t handles[100];
+
+	printf("=== keyed backend ===\n");
+	priqueue_init_keyed(&q, key_tens);
+	for (i = 0; i < 100; i++)
+		values[i] = (i * 37) % 100;
+
+	/* Enough elements for full 8-child blocks; equal keys come out FIFO. */
+	for (i = 0; i < 100; i++)
+		priqueue_offer_handle(&q, &values[i], &handles[i]);
+	printf("First elements (expected 0 7 3 6 2 9 5 1 8 4): ");
+	for (i = 0; i < 10; i++)
+		printf("%d ", *((int *)priqueue_at(&q, i)) );
+	printf("\n");
+
+	values[99] = 5;
+	priqueue_update_key(&q, handles[99]);
+	priqueue_remove_handle(&q, handles[0]);
+	printf("Polled after update_key and remove_handle (expected 7 3 6 2 9 5 1 8 4 5): ");
+	for (i = 0; i < 10; i++)
+		printf("%d ", *((int *)priqueue_poll(&q)) );
+	printf("\n");
+
+	int previous = -1, ordered = 1;
+	while (priqueue_size(&q) > 0)
+	{
+		int value = *((int *)priqueue_poll(&q));
+		ordered &= value / 10 >= previous;
+		previous = value / 10;
+	}
+	printf("Remaining elements polled in key order: %s (expected yes).\n", ordered ? "yes" : "no");
+	printf("\n");
+
+	priqueue_destroy(&q);
+}
+
+int main()
+{
+	test_backend(PRIQUEUE_LIST, "list");
+	test_backend(PRIQUEUE_HEAP, "heap");
+	test_backend(PRIQUEUE_RBTREE, "rbtree");
+	test_keyed();
+
+	return 0;
+}
@@ -1,492 +1,949 @@
-/*
- * CS 241
- * The University of Illinois
- */
-
-#include <stdio.h>
-#include <stdlib.h>
-#include <unistd.h>
-#include <string.h>
-#include <assert.h>
-
-#include "libscheduler/libscheduler.h"
-
-
-typedef struct _simulator_job_list_t
-{
-	int job_id, arrival_time, run_time, priority;
-	int core_id, arrived;
-} simulator_job_list_t;
-
-void print_usage(char *program_name)
-{
-	fprintf(stderr, "Usage: %s -c <cores> -s <scheme> <input file>\n", program_name);
-	fprintf(stderr, "       %s -c 2 -s fcfs examples/proc1.csv\n", program_name);
-	fprintf(stderr, "\n");
-	fprintf(stderr, "Acceptable schemes are: fcfs, sjf, psjf, pri, ppri, rr#\n");
-}
-
-int set_active_job(int job_id, int core_id, simulator_job_list_t *jobs, int active_jobs)
-{
-	int i;
-	for (i = 0; i < active_jobs; i++)
-	{
-		if (jobs[i].job_id == job_id && jobs[i].arrived)
-		{
-			jobs[i].core_id = core_id;
-			return 1;
-		}
-	}
-
-	return 0;
-}
-
-void print_available_jobs(simulator_job_list_t *jobs, int active_jobs)
-{
-	printf("Active jobs are: ");
-
-	int i, first = 1;
-	for (i = 0; i < active_jobs; i++)
-	{
-		if (jobs[i].arrived)
-		{
-			if (first)
-			{
-				printf("%d", jobs[i].job_id);
-				first = 0;
-			}
-			else
-				printf(", %d", jobs[i].job_id);
-		}
-	}
-
-	if (!first)
-		printf("\n");
-}
-
-void print_available_cores(int cores)
-{
-	printf("Active cores are: ");
-
-	int i;
-	for (i = 0; i < cores; i++)
-	{
-		if (i == cores - 1)
-			printf("%d\n", i);
-		else
-			printf("%d, ", i);
-	}
-}
-
-
-int main(int argc, char **argv)
-{
-	int c;
-	int cores = 0, scheme = -1, quantum = 0;
-	char *file_name;
-
-	/*
-	 * Parse command line options.
-	 */
-	while ((c = getopt(argc, argv, "c:s:")) != -1)
-	{
-		switch (c)
-		{
-			case 'c':
-				cores = atoi(optarg);
-
-				if (cores <= 0)
-				{
-					fprintf(stderr, "Option -c <cores> require a positive number.\n");
-					print_usage(argv[0]);
-					return 1;
-				}
-				break;
-
-			case 's':
-				if (strcasecmp(optarg, "FCFS") == 0) { scheme = FCFS; }
-				else if (strcasecmp(optarg, "SJF") == 0) { scheme = SJF; }
-				else if (strcasecmp(optarg, "PSJF") == 0) { scheme = PSJF; }
-				else if (strcasecmp(optarg, "PRI") == 0) { scheme = PRI; }
-				else if (strcasecmp(optarg, "PPRI") == 0) { scheme = PPRI; }
-				else if (strncasecmp(optarg, "RR", 2) == 0)
-				{
-					scheme = RR;
-					quantum = atoi(optarg + 2);
-
-					if (quantum <= 0)
-					{
-						fprintf(stderr, "Option -s <scheme> requires a positive number for the quantum of RR. (Eg: -s RR2)\n");
-						print_usage(argv[0]);
-						return 1;
-					}
-				}
-				break;
-
-			case '?':
-				print_usage(argv[0]);
-				return 1;
-
-			default:
-				printf("...\n");
-				break;
-		}
-	}
-
-	if (cores == 0)
-	{
-		fprintf(stderr, "Required option -c <cores> is not present.\n");
-		print_usage(argv[0]);
-		return 1;
-	}
-
-	if (scheme == -1)
-	{
-		fprintf(stderr, "Required option -s <scheme> is not present.\n");
-		print_usage(argv[0]);
-		return 1;
-	}
-
-	if (optind == argc - 1)
-		file_name = argv[optind];
-	else
-	{
-		fprintf(stderr, "A single input file is required.\n");
-		print_usage(argv[0]);
-		return 1;
-	}
-
-
-	/*
-	 * Open the file, read the file, and populate the jobs data structure.
-	 */
-	FILE *file = fopen(file_name, "r");
-	if (file == NULL)
-	{
-		fprintf(stderr, "Unable to open file \"%s\".\n", file_name);
-		return 2;
-	}
-
-
-	int job_id = 0;
-	int jobs_ct = 10;
-	simulator_job_list_t* jobs = malloc(jobs_ct * sizeof(simulator_job_list_t));
-
-	char line[1024 + 1];
-	fgets(line, 1024, file);  // Ignore the first (header) line
-	while (fgets(line, 1024, file) != NULL)
-	{
-		char *arrival_time = strtok(line, ",");
-		char *run_time = strtok(NULL, ",");
-		char *priority = strtok(NULL, ",");
-
-		if (arrival_time != NULL && run_time != NULL && priority != NULL)
-		{
-			if (job_id == jobs_ct)
-			{
-				jobs_ct *= 2;
-				jobs = realloc(jobs, jobs_ct * sizeof(simulator_job_list_t));
-
-				if (!jobs)
-				{
-					fprintf(stderr, "Out of memory.\n");
-					return 2;
-				}
-			}
-
-			jobs[job_id].job_id = job_id;
-			jobs[job_id].arrival_time = atoi(arrival_time);
-			jobs[job_id].run_time = atoi(run_time);
-			jobs[job_id].priority = atoi(priority);
-			jobs[job_id].core_id = -1;
-			jobs[job_id].arrived = 0;
-
-			job_id++;
-		}
-		else
-		{
-			fprintf(stderr, "Illegal file format.\n");
-			return 2;
-		}
-	}
-
-	fclose(file);
-
-
-	/*
-	 * Run the simulation.
-	 */
-
-	printf("Loaded %d core(s) and %d job(s) using ", cores, job_id);
-	if (scheme == FCFS) { printf("First Come First Served (FCFS)"); }
-	else if (scheme == SJF) { printf("Non-preemptive Shortest Job First (SJF)"); }
-	else if (scheme == PSJF) { printf("Preemptive Shortest Job First (PSJF)"); }
-	else if (scheme == PRI) { printf("Non-preemptive Priority (PRI)"); }
-	else if (scheme == PPRI) { printf("Preemptive Priority (PPRI)"); }
-	else if (scheme == RR) { printf("Round Robin (RR) with a quantum of %d", quantum); }
-	printf(" scheduling...\n\n");
-
-	scheduler_start_up(cores, scheme);
-
-
-	int time = 0, i, j;
-	int active_jobs = job_id, jobs_alive = 0;
-
-	int *quantum_clock = malloc(cores * sizeof(int));
-	char **core_timing_diagram = malloc(cores * sizeof(char *));
-	int core_timing_diagram_size = 1024;
-
-	for (i = 0; i < cores; i++)
-	{
-		quantum_clock[i] = -1;
-		core_timing_diagram[i] = malloc(core_timing_diagram_size + 1);
-		core_timing_diagram[i][0] = '\0';
-	}
-
-	while (active_jobs > 0)
-	{
-		printf("=== [TIME %d] ===\n", time);
-
-		/*
-		 * 1. Check if any jobs finished in the last time unit.
-		 */
-		for (i = 0; i < active_jobs; i++)
-		{
-			if (jobs[i].run_time == 0)
-			{
-				// Notify the scheduler has finished
-				int job_id = jobs[i].job_id;
-				int core_id = jobs[i].core_id;
-				int new_job_id = scheduler_job_finished(jobs[i].core_id, jobs[i].job_id, time);
-
-				if (scheme == RR)
-					quantum_clock[jobs[i].core_id] = quantum;
-
-				// Delete the finished jobs, decrease the number of active jobs
-				if (i != active_jobs - 1)
-					memcpy(&jobs[i], &jobs[active_jobs - 1], sizeof(simulator_job_list_t));
-				active_jobs--;
-				jobs_alive--;
-				i--;
-
-				// Set the new job
-				if ( new_job_id != -1 && !set_active_job(new_job_id, core_id, jobs, active_jobs) )
-				{
-					printf("The scheduler_job_finished() selected an invalid job (job_id == %d).\n", new_job_id);
-					print_available_jobs(jobs, active_jobs);
-					return 3;
-				}
-				else
-				{
-					printf("Job %d, running on core %d, finished. Core %d is now running job %d.\n", job_id, core_id, core_id, new_job_id);
-					printf("  Queue: "); scheduler_show_queue(); printf("\n\n");
-				}
-			}
-		}
-
-		/*
-		 * Check to see if we finished our last job.  (If we don't check here, we would run an extra time unit that will be totally idle.)
-		 */
-		if (active_jobs == 0)
-			break;
-
-		/*
-		 * 2. Check of any quantums expired in the last time unit.
-		 */
-		if (scheme == RR)
-		{
-			for (i = 0; i < cores; i++)
-			{
-				if (quantum_clock[i] == 0)
-				{
-					for (j = 0; j < active_jobs; j++)
-					{
-						if (jobs[j].core_id == i)
-						{
-							// Notify the scheduler the quantum has expired
-							int core_id = jobs[j].core_id;
-							int old_job_id = jobs[j].job_id;
-							int new_job_id = scheduler_quantum_expired(jobs[j].core_id, time);
-
-							jobs[j].core_id = -1;
-
-							quantum_clock[core_id] = quantum;
-
-							// Set the new job
-							if ( new_job_id != -1 && !set_active_job(new_job_id, core_id, jobs, active_jobs) )
-							{
-								printf("The scheduler_quantum_expired() selected an invalid job (job_id == %d).\n", new_job_id);
-								print_available_jobs(jobs, active_jobs);
-								return 3;
-							}
-							else
-							{
-								printf("Job %d, running on core %d, had its quantum expire. Core %d is now running job %d.\n", old_job_id, core_id, core_id, new_job_id);
-								printf("  Queue: "); scheduler_show_queue(); printf("\n\n");
-							}
-
-							break;
-						}
-					}
-				}
-			}
-		}
-
-
-		/*
-		 * 3. Check for any new jobs that arrive in this time unit
-		 */
-		for (i = 0; i < active_jobs; i++)
-		{
-			if (jobs[i].arrival_time == time)
-			{
-				int new_job_core_id = scheduler_new_job(jobs[i].job_id, time, jobs[i].run_time, jobs[i].priority);
-				jobs[i].arrived = 1;
-				jobs_alive++;
-
-				if (new_job_core_id >= 0 && new_job_core_id < cores)
-				{
-					printf("A new job, job %d (running time=%d, priority=%d), arrived. Job %d is now running on core %d.\n",
-							jobs[i].job_id, jobs[i].run_time, jobs[i].priority, jobs[i].job_id, new_job_core_id);
-					printf("  Queue: "); scheduler_show_queue(); printf("\n\n");
-
-					// Find if anyone is currently using the core.
-					for (j = 0; j < active_jobs; j++)
-						if (jobs[j].core_id == new_job_core_id)
-							jobs[j].core_id = -1;
-
-					// Assign the core to the new job
-					jobs[i].core_id = new_job_core_id;
-
-					if (scheme == RR)
-						quantum_clock[new_job_core_id] = quantum;
-				}
-				else if (new_job_core_id == -1)
-				{
-					printf("A new job, job %d (running time=%d, priority=%d), arrived. Job %d is set to idle (-1).\n",
-							jobs[i].job_id, jobs[i].run_time, jobs[i].priority, jobs[i].job_id);
-					printf("  Queue: "); scheduler_show_queue(); printf("\n\n");
-				}
-				else
-				{
-					printf("The scheduler_new_job() selected an invalid core (core_id == %d).\n", new_job_core_id);
-					print_available_cores(cores);
-					return 3;
-				}
-			}
-		}
-
-
-		/*
-		 * 4. Run the time unit.
-		 */
-		char time_string[cores][11];
-		int cores_working = 0;
-
-		for (i = 0; i < cores; i++)
-			time_string[i][0] = '\0';
-
-		for (i = 0; i < active_jobs; i++)
-		{
-			if (jobs[i].core_id != -1)
-			{
-				cores_working++;
-				jobs[i].run_time--;
-				quantum_clock[jobs[i].core_id]--;
-
-				assert(time_string[jobs[i].core_id][0] == '\0');
-
-				if (jobs[i].job_id < 10)
-					sprintf(time_string[jobs[i].core_id], "%d", jobs[i].job_id);
-				else if (jobs[i].job_id < 10 + 26)
-					sprintf(time_string[jobs[i].core_id], "%c", jobs[i].job_id - 10 + 'a');
-				else if (jobs[i].job_id < 10 + 26 + 26)
-					sprintf(time_string[jobs[i].core_id], "%c", jobs[i].job_id - 10 - 26 + 'A');
-				else
-					snprintf(time_string[jobs[i].core_id], 10, "(%d)", jobs[i].job_id);
-			}
-		}
-
-		for (i = 0; i < cores; i++)
-		{
-			// If the core is idle, print a '-'
-			if (time_string[i][0] == '\0')
-				strcpy(time_string[i], "-");
-
-			// Ensure we have enough memory
-			while (strlen(core_timing_diagram[i]) + strlen(time_string[i]) >= (unsigned int)core_timing_diagram_size)
-			{
-				core_timing_diagram_size *= 2;
-
-				for (j = 0; j < cores; j++)
-				{
-					core_timing_diagram[j] = realloc(core_timing_diagram[j], core_timing_diagram_size + 1);
-
-					if (core_timing_diagram[j] == NULL)
-					{
-						fprintf(stderr, "Out of memory.\n");
-						return 3;
-					}
-				}
-			}
-
-			strcat( core_timing_diagram[i], time_string[i] );
-		}
-
-
-		/*
-		 * 5. Print data!
-		 */
-		printf("At the end of time unit %d...\n", time);
-
-		for (i = 0; i < cores; i++)
-			printf("  Core %2d: %s\n", i, core_timing_diagram[i]);
-
-		printf("\n");
-
-		printf("  Queue: ");
-		scheduler_show_queue();
-		printf("\n");
-		printf("\n");
-
-
-		/*
-		 * 6. Sanity Checking
-		 *
-		 * - If there's a job alive (needing to be ran) and all CPUs are idle, the scheduler failed to schedule properly.
-		 */
-		if (jobs_alive > 0 && cores_working == 0)
-		{
-			printf("All cores are idle and at least one job remains unscheduled.\n");
-			print_available_jobs(jobs, active_jobs);
-			return 3;
-		}
-
-
-		/*
-		 * 7. Increase time
-		 */
-		time++;
-	}
-
-
-	printf("FINAL TIMING DIAGRAM:\n");
-	for (i = 0; i < cores; i++)
-		printf("  Core %2d: %s\n", i, core_timing_diagram[i]);
-
-	printf("\n");
-	printf("Average Waiting Time: %.2f\n", scheduler_average_waiting_time());
-	printf("Average Turnaround Time: %.2f\n", scheduler_average_turnaround_time());
-	printf("Average Response Time: %.2f\n", scheduler_average_response_time());
-
-	scheduler_clean_up();
-
-
-	free(quantum_clock);
-	for (i=0; i < cores; i++)
-		free(core_timing_diagram[i]);
-	free(core_timing_diagram);
-	free(jobs);
-
-	return 0;
-}
+/*
+ * CS 241
+ * The University of Illinois
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <getopt.h>
+#include <sys/resource.h>
+#include <string.h>
+#include <time.h>
+
+#include "libscheduler/libscheduler.h"
+#include "libsimulation/libsimulation.h"
+#include "libtrace/libtrace.h"
+
+
+/*
+ * Output levels selected with -v (-q is level 0). Each level adds to the
+ * one before it; LOG_TICKS is the classic per-time-unit output.
+ */
+#define LOG_QUIET 0 // final averages and statistics only
+#define LOG_EVENTS 1 // every scheduling event and the final timing diagram
+#define LOG_TICKS 2 // the timing diagram and queue after every time unit
+#define LOG_DEBUG 3 // trace loading statistics
+
+#define OUTPUT_BUFFER_SIZE (1 << 20)
+
+/**
+  A stretch of time a core spent on one job (job_id -1 when idle).
+*/
+typedef struct _diagram_segment_t
+{
+	int job_id, start, length;
+} diagram_segment_t;
+
+/**
+  Timing diagram of one core, stored as run-length segments so it grows
+  with the number of context switches rather than with time.
+*/
+typedef struct _core_diagram_t
+{
+	diagram_segment_t *segments;
+	int count, capacity;
+} core_diagram_t;
+
+/**
+  What the simulator's hooks need besides the simulation: the output level,
+  the timing diagrams and, when streaming, the open trace.
+*/
+typedef struct _simulator_output_t
+{
+	int verbosity;
+	core_diagram_t *diagrams; // NULL unless the diagram is printed or exported
+	trace_t *reader;
+	int trace_capacity, jobs_loaded;
+	double parse_seconds;
+} simulator_output_t;
+
+void print_usage(char *program_name)
+{
+	fprintf(stderr, "Usage: %s -c <cores> -s <scheme> [-q | -v <level>] [--event-driven] [--stream] [--steal=one|half] [--gantt <file>] [--timing] [--latency] [--aging=<period>]\n", program_name);
+	fprintf(stderr, "       [--switch-cost=<units>] [--migration-cost=<units>] <input file>\n");
+	fprintf(stderr, "       %s -c 2 -s fcfs examples/proc1.csv\n", program_name);
+	fprintf(stderr, "\n");
+	fprintf(stderr, "Acceptable schemes are: fcfs, sjf, psjf, pri, ppri, rr#, mlfq[:<quantum>,...[:<boost period>]],\n");
+	fprintf(stderr, "   cfs[:<target latency>[:<min granularity>]], edf\n");
+	fprintf(stderr, "   (mlfq alone has 3 levels with quanta 2,4,8 and boosts every 100 time units; 0 never boosts;\n");
+	fprintf(stderr, "   cfs alone has a target latency of 24 and slices of at least 3, with the priority as nice value).\n");
+	fprintf(stderr, "   cfs has no wakeup preemption: a new job never preempts a running one, it waits for a slice to end.\n");
+	fprintf(stderr, "-q prints only the final averages; -v 1 logs scheduling events, -v 2 (the default) adds the\n");
+	fprintf(stderr, "   timing diagram after every time unit and -v 3 adds trace loading statistics.\n");
+	fprintf(stderr, "--event-driven skips directly to the next arrival, completion, quantum expiry or end of a switch stall.\n");
+	fprintf(stderr, "   Up to %d cores the next event is found by scanning them; above that, busy cores are kept in\n", SIMULATION_HEAP_CORES);
+	fprintf(stderr, "   a heap by their next event and a step costs O(log cores) per core with an event.\n");
+	fprintf(stderr, "--stream parses jobs as they arrive instead of loading the whole (arrival-sorted) trace;\n");
+	fprintf(stderr, "   memory then grows with the jobs active at once, not with the length of the trace.\n");
+	fprintf(stderr, "   Events at the same time unit are then handled in job id order, which may differ from bulk mode.\n");
+	fprintf(stderr, "--steal gives each core its own run queue; idle cores steal one job or half a queue from the longest peer.\n");
+	fprintf(stderr, "--gantt <file> writes every core's schedule as CSV rows of core, job, start and length.\n");
+	fprintf(stderr, "--timing reports the trace parse rate, the simulated time units and scheduler events per second\n");
+	fprintf(stderr, "   and the peak memory use.\n");
+	fprintf(stderr, "--latency reports waiting, response and turnaround percentiles, overall and per priority,\n");
+	fprintf(stderr, "   and each core's throughput and utilization.\n");
+	fprintf(stderr, "--aging raises a waiting pri or ppri job one priority level every <period> time units (0: never)\n");
+	fprintf(stderr, "   and reports the maximum waiting time.\n");
+	fprintf(stderr, "--switch-cost charges a core that starts a job other than the one it ran last; --migration-cost\n");
+	fprintf(stderr, "   is added when the job last ran on another core. The core stalls that long before the job's\n");
+	fprintf(stderr, "   work and quantum resume; switches, migrations and the overhead are reported per core.\n");
+	fprintf(stderr, "An optional fourth CSV column gives each job a deadline (the time it should finish by);\n");
+	fprintf(stderr, "   edf runs the earliest deadline first and misses, lateness and tardiness are reported.\n");
+	fprintf(stderr, "The input file is a CSV trace or a binary trace produced by csv2trace.\n");
+}
+
+/*
+ * Parses the levels of "mlfq[:<quantum>,<quantum>,...[:<boost period>]]"
+ * into config. Returns 0 on success, -1 if malformed.
+ */
+int parse_mlfq(const char *spec, mlfq_config_t *config)
+{
+	mlfq_config_t defaults = MLFQ_DEFAULT_CONFIG;
+	char *end;
+
+	*config = defaults;
+	if (strncasecmp(spec, "MLFQ", 4) != 0)
+		return -1;
+	spec += 4;
+	if (*spec == '\0')
+		return 0;
+	if (*spec != ':')
+		return -1;
+
+	config->levels = 0;
+	do
+	{
+		if (config->levels == MLFQ_MAX_LEVELS)
+			return -1;
+		config->quantum[config->levels] = strtol(spec + 1, &end, 10);
+		if (end == spec + 1 || config->quantum[config->levels++] <= 0)
+			return -1;
+		spec = end;
+	} while (*spec == ',');
+
+	if (*spec == ':')
+	{
+		config->boost_period = strtol(spec + 1, &end, 10);
+		if (end == spec + 1 || config->boost_period < 0)
+			return -1;
+		spec = end;
+	}
+	return *spec == '\0' ? 0 : -1;
+}
+
+/*
+ * Parses "cfs[:<target latency>[:<min granularity>]]" into config.
+ * Returns 0 on success, -1 if malformed.
+ */
+int parse_cfs(const char *spec, cfs_config_t *config)
+{
+	cfs_config_t defaults = CFS_DEFAULT_CONFIG;
+	char *end;
+
+	*config = defaults;
+	if (strncasecmp(spec, "CFS", 3) != 0)
+		return -1;
+	spec += 3;
+
+	if (*spec == ':')
+	{
+		config->target_latency = strtol(spec + 1, &end, 10);
+		if (end == spec + 1 || config->target_latency <= 0)
+			return -1;
+		spec = end;
+	}
+	if (*spec == ':')
+	{
+		config->min_granularity = strtol(spec + 1, &end, 10);
+		if (end == spec + 1 || config->min_granularity <= 0)
+			return -1;
+		spec = end;
+	}
+	return *spec == '\0' ? 0 : -1;
+}
+
+double seconds_since(struct timespec *start)
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (now.tv_sec - start->tv_sec) + (now.tv_nsec - start->tv_nsec) / 1e9;
+}
+
+/*
+ * Appends the next job of the trace to the arrival list, growing it as needed.
+ * Returns 1 if a job was read, 0 at the end of the trace and -1 on a malformed line.
+ */
+int read_job(trace_t *reader, simulation_job_t **trace, int *count, int *capacity, int job_id)
+{
+	trace_job_t job;
+	int status = trace_next(reader, &job);
+
+	if (status <= 0)
+		return status;
+
+	if (*count == *capacity)
+	{
+		*capacity *= 2;
+		*trace = realloc(*trace, *capacity * sizeof(simulation_job_t));
+
+		if (!*trace)
+		{
+			fprintf(stderr, "Out of memory.\n");
+			exit(2);
+		}
+	}
+
+	simulation_job_t *entry = &(*trace)[(*count)++];
+	entry->job_id = job_id;
+	entry->arrival_time = job.arrival_time;
+	entry->run_time = job.run_time;
+	entry->priority = job.priority;
+	entry->deadline = job.deadline;
+	entry->core_id = -1;
+	entry->arrived = 0;
+	entry->last_core = -1;
+
+	return 1;
+}
+
+/*
+ * Streaming mode: drops the jobs that already arrived from the arrival list and
+ * parses every job arriving at or before time, plus one job arriving later, so
+ * the next arrival time is always known.
+ * Returns 0 on success and -1 if the trace is malformed or not sorted by arrival.
+ */
+int stream_arrivals(trace_t *reader, simulation_job_t **trace, int *next_arrival, int *count, int *capacity, int *jobs_loaded, int time)
+{
+	if (*next_arrival > 0)
+	{
+		memmove(*trace, *trace + *next_arrival, (*count - *next_arrival) * sizeof(simulation_job_t));
+		*count -= *next_arrival;
+		*next_arrival = 0;
+	}
+
+	while (*count == 0 || (*trace)[*count - 1].arrival_time <= time)
+	{
+		int status = read_job(reader, trace, count, capacity, *jobs_loaded);
+
+		if (status == 0)
+			break;
+		if (status < 0 || (*trace)[*count - 1].arrival_time < time)
+			return -1;
+
+		(*jobs_loaded)++;
+	}
+
+	return 0;
+}
+
+void print_available_jobs(simulation_job_t *jobs, int active_jobs)
+{
+	printf("Active jobs are: ");
+
+	int i, first = 1;
+	for (i = 0; i < active_jobs; i++)
+	{
+		if (jobs[i].arrived)
+		{
+			if (first)
+			{
+				printf("%d", jobs[i].job_id);
+				first = 0;
+			}
+			else
+				printf(", %d", jobs[i].job_id);
+		}
+	}
+
+	if (!first)
+		printf("\n");
+}
+
+/*
+ * Records that job_id (-1 for idle) ran on a core for span units from start,
+ * extending the last segment when the same job keeps running.
+ */
+void diagram_append(core_diagram_t *diagram, int job_id, int start, int span)
+{
+	diagram_segment_t *last = diagram->count ? &diagram->segments[diagram->count - 1] : NULL;
+
+	if (last != NULL && last->job_id == job_id && last->start + last->length == start)
+	{
+		last->length += span;
+		return;
+	}
+
+	if (diagram->count == diagram->capacity)
+	{
+		diagram->capacity = diagram->capacity ? diagram->capacity * 2 : 64;
+		diagram->segments = realloc(diagram->segments, diagram->capacity * sizeof(diagram_segment_t));
+
+		if (!diagram->segments)
+		{
+			fprintf(stderr, "Out of memory.\n");
+			exit(2);
+		}
+	}
+
+	diagram->segments[diagram->count++] = (diagram_segment_t){ job_id, start, span };
+}
+
+/*
+ * Renders a core's diagram in the classic format: one character (or
+ * "(id)" past 'Z') per time unit, '-' while idle.
+ */
+void diagram_print(FILE *out, core_diagram_t *diagram)
+{
+	char label[16], chunk[4096];
+	int k;
+
+	for (k = 0; k < diagram->count; k++)
+	{
+		diagram_segment_t *segment = &diagram->segments[k];
+		int job_id = segment->job_id;
+
+		if (job_id == -1)
+			strcpy(label, "-");
+		else if (job_id < 10)
+			sprintf(label, "%d", job_id);
+		else if (job_id < 10 + 26)
+			sprintf(label, "%c", job_id - 10 + 'a');
+		else if (job_id < 10 + 26 + 26)
+			sprintf(label, "%c", job_id - 10 - 26 + 'A');
+		else
+			snprintf(label, sizeof(label), "(%d)", job_id);
+
+		// Write the label length times, a chunk of repetitions at a time
+		int label_length = strlen(label), per_chunk = sizeof(chunk) / label_length, filled = 0, left;
+		for (left = segment->length; left > 0; left -= per_chunk)
+		{
+			int n = left < per_chunk ? left : per_chunk;
+			for (; filled < n; filled++)
+				memcpy(chunk + filled * label_length, label, label_length);
+			fwrite(chunk, label_length, n, out);
+		}
+	}
+}
+
+/*
+ * Writes the busy segments of every core as CSV Gantt data.
+ * Returns 0 on success, -1 if the file cannot be written.
+ */
+int diagram_export_gantt(const char *file_name, core_diagram_t *diagrams, int cores)
+{
+	FILE *out = fopen(file_name, "w");
+	int c, k;
+
+	if (out == NULL)
+		return -1;
+
+	fprintf(out, "core,job,start,length\n");
+	for (c = 0; c < cores; c++)
+		for (k = 0; k < diagrams[c].count; k++)
+			if (diagrams[c].segments[k].job_id != -1)
+				fprintf(out, "%d,%d,%d,%d\n", c, diagrams[c].segments[k].job_id, diagrams[c].segments[k].start, diagrams[c].segments[k].length);
+
+	return fclose(out) == 0 ? 0 : -1;
+}
+
+void print_available_cores(int cores)
+{
+	printf("Active cores are: ");
+
+	int i;
+	for (i = 0; i < cores; i++)
+	{
+		if (i == cores - 1)
+			printf("%d\n", i);
+		else
+			printf("%d, ", i);
+	}
+}
+
+/*
+ * The simulation hooks: log every event at LOG_EVENTS, and at LOG_TICKS
+ * the diagram and queue after every step.
+ */
+static void print_step(simulation_t *sim)
+{
+	printf("=== [TIME %d] ===\n", sim->time);
+}
+
+static void print_finished(simulation_t *sim, int job_id, int core_id, int new_job_id)
+{
+	printf("Job %d, running on core %d, finished. Core %d is now running job %d.\n", job_id, core_id, core_id, new_job_id);
+	printf("  Queue: "); scheduler_ctx_show_queue(sim->ctx, stdout); printf("\n\n");
+}
+
+static void print_expired(simulation_t *sim, int job_id, int core_id, int new_job_id)
+{
+	printf("Job %d, running on core %d, had its quantum expire. Core %d is now running job %d.\n", job_id, core_id, core_id, new_job_id);
+	printf("  Queue: "); scheduler_ctx_show_queue(sim->ctx, stdout); printf("\n\n");
+}
+
+static void print_arrived(simulation_t *sim, const simulation_job_t *job, int core_id)
+{
+	if (core_id == -1)
+		printf("A new job, job %d (running time=%d, priority=%d), arrived. Job %d is set to idle (-1).\n",
+				job->job_id, job->run_time, job->priority, job->job_id);
+	else
+		printf("A new job, job %d (running time=%d, priority=%d), arrived. Job %d is now running on core %d.\n",
+				job->job_id, job->run_time, job->priority, job->job_id, core_id);
+	printf("  Queue: "); scheduler_ctx_show_queue(sim->ctx, stdout); printf("\n\n");
+}
+
+static void record_span(simulation_t *sim, int span)
+{
+	simulator_output_t *out = sim->hooks.arg;
+	int c;
+
+	if (out->diagrams != NULL)
+		for (c = 0; c < sim->cores; c++)
+			diagram_append(&out->diagrams[c], sim->running[c] != -1 ? sim->jobs[sim->running[c]].job_id : -1, sim->time, span);
+
+	if (out->verbosity >= LOG_TICKS)
+	{
+		printf("At the end of time unit %d...\n", sim->time + span - 1);
+
+		for (c = 0; c < sim->cores; c++)
+		{
+			printf("  Core %2d: ", c);
+			diagram_print(stdout, &out->diagrams[c]);
+			printf("\n");
+		}
+
+		printf("\n");
+
+		printf("  Queue: ");
+		scheduler_ctx_show_queue(sim->ctx, stdout);
+		printf("\n");
+		printf("\n");
+	}
+}
+
+static int stream_hook(simulation_t *sim)
+{
+	simulator_output_t *out = sim->hooks.arg;
+	struct timespec parse_start;
+	int status;
+
+	clock_gettime(CLOCK_MONOTONIC, &parse_start);
+	status = stream_arrivals(out->reader, &sim->trace, &sim->next_arrival, &sim->trace_count, &out->trace_capacity, &out->jobs_loaded, sim->time);
+	out->parse_seconds += seconds_since(&parse_start);
+	return status;
+}
+
+
+/*
+ * Prints one row of latency percentiles.
+ */
+static void print_latency_row(const char *label, const latency_stats_t *stats)
+{
+	printf("  %-22s %7d %7d %7d %7d %7d %9.2f\n", label,
+		stats->p50, stats->p90, stats->p99, stats->p999, stats->max, stats->mean);
+}
+
+/*
+ * Prints the latency distributions of all jobs and of each priority, then
+ * the throughput and utilization of every core.
+ */
+static void print_latency(scheduler_ctx_t *ctx, int cores)
+{
+	static const char *metric_names[LATENCY_METRICS] = { "Waiting", "Response", "Turnaround" };
+	latency_stats_t stats;
+	char label[64];
+	int i, m;
+
+	scheduler_ctx_latency_stats(ctx, LATENCY_WAITING, &stats);
+	printf("\nLATENCY (%lld job(s)):\n", stats.jobs);
+	printf("  %-22s %7s %7s %7s %7s %7s %9s\n", "", "p50", "p90", "p99", "p99.9", "max", "mean");
+	for (m = 0; m < LATENCY_METRICS; m++)
+	{
+		scheduler_ctx_latency_stats(ctx, m, &stats);
+		print_latency_row(metric_names[m], &stats);
+	}
+
+	int num_classes = scheduler_ctx_priority_classes(ctx, NULL, 0);
+	int *priorities = malloc(num_classes * sizeof(int));
+	scheduler_ctx_priority_classes(ctx, priorities, num_classes);
+	for (i = 0; i < num_classes; i++)
+	{
+		for (m = 0; m < LATENCY_METRICS; m++)
+		{
+			scheduler_ctx_priority_latency_stats(ctx, priorities[i], m, &stats);
+			if (priorities[i] == LATENCY_OTHER_PRIORITIES)
+				snprintf(label, sizeof(label), "Others %s", metric_names[m]);
+			else
+				snprintf(label, sizeof(label), "Priority %d %s", priorities[i], metric_names[m]);
+			print_latency_row(label, &stats);
+		}
+	}
+	free(priorities);
+
+	printf("\nCORE USAGE:\n");
+	for (i = 0; i < cores; i++)
+	{
+		core_usage_t usage;
+		scheduler_ctx_core_usage(ctx, i, &usage);
+		printf("  Core %2d: %d job(s) finished, busy %lld time unit(s), throughput %.4f jobs/unit, utilization %.2f%%\n",
+			i, usage.jobs_finished, usage.busy_time, usage.throughput, 100.0 * usage.utilization);
+	}
+}
+
+int main(int argc, char **argv)
+{
+	int c;
+	int cores = 0, scheme = -1, quantum = 0, event_driven = 0, stream = 0, timing = 0, latency = 0;
+	mlfq_config_t mlfq = MLFQ_DEFAULT_CONFIG;
+	cfs_config_t cfs = CFS_DEFAULT_CONFIG;
+	int aging = -1; // -1: no --aging, so the maximum waiting time is not reported
+	int switch_cost = -1, migration_cost = -1; // -1: not given, so switches are not counted
+	int verbosity = LOG_TICKS;
+	char *gantt_name = NULL;
+	steal_policy_t steal_policy = STEAL_NONE;
+	char *file_name;
+
+	static struct option long_options[] =
+	{
+		{ "event-driven", no_argument, NULL, 'e' },
+		{ "stream", no_argument, NULL, 'S' },
+		{ "steal", required_argument, NULL, 'w' },
+		{ "timing", no_argument, NULL, 't' },
+		{ "gantt", required_argument, NULL, 'g' },
+		{ "aging", required_argument, NULL, 'a' },
+		{ "latency", no_argument, NULL, 'l' },
+		{ "switch-cost", required_argument, NULL, 'x' },
+		{ "migration-cost", required_argument, NULL, 'm' },
+		{ NULL, 0, NULL, 0 }
+	};
+
+	/*
+	 * Parse command line options.
+	 */
+	while ((c = getopt_long(argc, argv, "c:s:qv:", long_options, NULL)) != -1)
+	{
+		switch (c)
+		{
+			case 'e':
+				event_driven = 1;
+				break;
+
+			case 'S':
+				stream = 1;
+				break;
+
+			case 't':
+				timing = 1;
+				break;
+
+			case 'l':
+				latency = 1;
+				break;
+
+			case 'x':
+			case 'm':
+				if (atoi(optarg) < 0 || optarg[0] < '0' || optarg[0] > '9')
+				{
+					fprintf(stderr, "Option --%s requires a cost of 0 or more time units.\n", c == 'x' ? "switch-cost" : "migration-cost");
+					print_usage(argv[0]);
+					return 1;
+				}
+				*(c == 'x' ? &switch_cost : &migration_cost) = atoi(optarg);
+				break;
+
+			case 'q':
+				verbosity = LOG_QUIET;
+				break;
+
+			case 'g':
+				gantt_name = optarg;
+				break;
+
+			case 'a':
+				aging = atoi(optarg);
+
+				if (aging < 0 || optarg[0] < '0' || optarg[0] > '9')
+				{
+					fprintf(stderr, "Option --aging requires a period of 0 or more time units.\n");
+					print_usage(argv[0]);
+					return 1;
+				}
+				break;
+
+			case 'v':
+				verbosity = atoi(optarg);
+
+				if (verbosity < LOG_QUIET || verbosity > LOG_DEBUG || optarg[0] < '0' || optarg[0] > '9')
+				{
+					fprintf(stderr, "Option -v <level> requires a level from %d to %d.\n", LOG_QUIET, LOG_DEBUG);
+					print_usage(argv[0]);
+					return 1;
+				}
+				break;
+
+			case 'w':
+				if (strcasecmp(optarg, "one") == 0) { steal_policy = STEAL_ONE; }
+				else if (strcasecmp(optarg, "half") == 0) { steal_policy = STEAL_HALF; }
+				else
+				{
+					fprintf(stderr, "Option --steal requires one or half.\n");
+					print_usage(argv[0]);
+					return 1;
+				}
+				break;
+
+			case 'c':
+				cores = atoi(optarg);
+
+				if (cores <= 0)
+				{
+					fprintf(stderr, "Option -c <cores> require a positive number.\n");
+					print_usage(argv[0]);
+					return 1;
+				}
+				break;
+
+			case 's':
+				if (strcasecmp(optarg, "FCFS") == 0) { scheme = FCFS; }
+				else if (strcasecmp(optarg, "SJF") == 0) { scheme = SJF; }
+				else if (strcasecmp(optarg, "PSJF") == 0) { scheme = PSJF; }
+				else if (strcasecmp(optarg, "PRI") == 0) { scheme = PRI; }
+				else if (strcasecmp(optarg, "PPRI") == 0) { scheme = PPRI; }
+				else if (strcasecmp(optarg, "EDF") == 0) { scheme = EDF; }
+				else if (strncasecmp(optarg, "RR", 2) == 0)
+				{
+					scheme = RR;
+					quantum = atoi(optarg + 2);
+
+					if (quantum <= 0)
+					{
+						fprintf(stderr, "Option -s <scheme> requires a positive number for the quantum of RR. (Eg: -s RR2)\n");
+						print_usage(argv[0]);
+						return 1;
+					}
+				}
+				else if (strncasecmp(optarg, "MLFQ", 4) == 0)
+				{
+					scheme = MLFQ;
+
+					if (parse_mlfq(optarg, &mlfq) != 0)
+					{
+						fprintf(stderr, "Option -s <scheme> requires positive quanta for the levels of MLFQ. (Eg: -s mlfq:2,4,8:100)\n");
+						print_usage(argv[0]);
+						return 1;
+					}
+				}
+				else if (strncasecmp(optarg, "CFS", 3) == 0)
+				{
+					scheme = CFS;
+
+					if (parse_cfs(optarg, &cfs) != 0)
+					{
+						fprintf(stderr, "Option -s <scheme> requires a positive target latency and minimum granularity for CFS. (Eg: -s cfs:24:3)\n");
+						print_usage(argv[0]);
+						return 1;
+					}
+				}
+				break;
+
+			case '?':
+				print_usage(argv[0]);
+				return 1;
+
+			default:
+				printf("...\n");
+				break;
+		}
+	}
+
+	if (cores == 0)
+	{
+		fprintf(stderr, "Required option -c <cores> is not present.\n");
+		print_usage(argv[0]);
+		return 1;
+	}
+
+	if (scheme == -1)
+	{
+		fprintf(stderr, "Required option -s <scheme> is not present.\n");
+		print_usage(argv[0]);
+		return 1;
+	}
+
+	if (aging >= 0 && scheme != PRI && scheme != PPRI)
+	{
+		fprintf(stderr, "Option --aging only applies to the pri and ppri schemes.\n");
+		print_usage(argv[0]);
+		return 1;
+	}
+
+	int count_switches = switch_cost >= 0 || migration_cost >= 0;
+	if (switch_cost < 0)
+		switch_cost = 0;
+	if (migration_cost < 0)
+		migration_cost = 0;
+
+	if (optind == argc - 1)
+		file_name = argv[optind];
+	else
+	{
+		fprintf(stderr, "A single input file is required.\n");
+		print_usage(argv[0]);
+		return 1;
+	}
+
+
+	/*
+	 * Open the file, read the file, and populate the jobs data structure.
+	 */
+	trace_t reader;
+	int open_status = trace_open(&reader, file_name);
+
+	if (open_status == -2)
+	{
+		fprintf(stderr, "File \"%s\" is not a valid binary trace (bad version, size or checksum).\n", file_name);
+		fprintf(stderr, "Versions %d and %d are read; convert the CSV again with csv2trace for this build.\n", TRACE_VERSION_NO_DEADLINES, TRACE_VERSION);
+		return 2;
+	}
+	else if (open_status != 0)
+	{
+		fprintf(stderr, "Unable to open file \"%s\".\n", file_name);
+		return 2;
+	}
+
+
+	int job_id = 0, jobs_loaded = 0;
+	int jobs_ct = 10;
+	simulation_job_t* trace = malloc(jobs_ct * sizeof(simulation_job_t));
+
+	struct timespec parse_start;
+	double parse_seconds = 0.0;
+
+	if (!stream)
+	{
+		int status;
+
+		clock_gettime(CLOCK_MONOTONIC, &parse_start);
+		while ((status = read_job(&reader, &trace, &job_id, &jobs_ct, jobs_loaded)) == 1)
+			jobs_loaded++;
+		parse_seconds = seconds_since(&parse_start);
+
+		if (status < 0)
+		{
+			fprintf(stderr, "Illegal file format.\n");
+			return 2;
+		}
+
+		if (verbosity >= LOG_DEBUG || timing)
+			trace_report(&reader, reader.binary ? "Loaded" : "Parsed", parse_seconds);
+
+		/*
+		 * Order the trace by arrival so arrivals are consumed through a cursor
+		 * instead of checking every job on every time unit. Binary traces
+		 * record whether they are already in that order.
+		 */
+		if (!(reader.binary && (reader.flags & TRACE_SORTED)))
+			qsort(trace, job_id, sizeof(simulation_job_t), simulation_compare_arrival);
+
+		trace_close(&reader);
+	}
+
+
+	/*
+	 * Run the simulation.
+	 */
+
+	/*
+	 * Large runs write a lot; a big buffer keeps them from being bound by
+	 * write() calls.
+	 */
+	setvbuf(stdout, NULL, _IOFBF, OUTPUT_BUFFER_SIZE);
+
+	if (verbosity >= LOG_EVENTS)
+	{
+		if (stream)
+			printf("Loaded %d core(s) and streaming jobs from \"%s\" using ", cores, file_name);
+		else
+			printf("Loaded %d core(s) and %d job(s) using ", cores, job_id);
+		if (scheme == FCFS) { printf("First Come First Served (FCFS)"); }
+		else if (scheme == SJF) { printf("Non-preemptive Shortest Job First (SJF)"); }
+		else if (scheme == PSJF) { printf("Preemptive Shortest Job First (PSJF)"); }
+		else if (scheme == PRI) { printf("Non-preemptive Priority (PRI)"); }
+		else if (scheme == PPRI) { printf("Preemptive Priority (PPRI)"); }
+		else if (scheme == RR) { printf("Round Robin (RR) with a quantum of %d", quantum); }
+		else if (scheme == MLFQ)
+		{
+			printf("Multi-level Feedback Queue (MLFQ) with quanta");
+			for (int level = 0; level < mlfq.levels; level++)
+				printf("%s%d", level ? "," : " ", mlfq.quantum[level]);
+			if (mlfq.boost_period > 0)
+				printf(" and a boost every %d time units", mlfq.boost_period);
+		}
+		else if (scheme == EDF) { printf("Preemptive Earliest Deadline First (EDF)"); }
+		else if (scheme == CFS) { printf("Completely Fair Scheduler (CFS) with a target latency of %d and a minimum granularity of %d", cfs.target_latency, cfs.min_granularity); }
+		printf(" scheduling...\n\n");
+	}
+
+	scheduler_ctx_t *ctx = scheduler_create(cores, scheme, steal_policy);
+	if (scheme == MLFQ)
+		scheduler_ctx_set_mlfq(ctx, &mlfq);
+	if (scheme == CFS)
+		scheduler_ctx_set_cfs(ctx, &cfs);
+	if (aging > 0)
+		scheduler_ctx_set_aging(ctx, aging);
+
+	struct timespec run_start;
+	clock_gettime(CLOCK_MONOTONIC, &run_start);
+
+	/*
+	 * Bulk mode reproduces the legacy report order. Doing so needs state for
+	 * every job in the trace, so a stream reports simultaneous finishes and
+	 * arrivals in job id (file) order instead.
+	 */
+	simulation_t sim;
+	simulation_init(&sim, ctx, cores, scheme, quantum, trace, job_id, !stream);
+	sim.event_driven = event_driven;
+	sim.count_switches = count_switches;
+	sim.switch_cost = switch_cost;
+	sim.migration_cost = migration_cost;
+
+	int i, keep_diagram = verbosity >= LOG_EVENTS || gantt_name != NULL;
+	core_diagram_t *core_timing_diagram = calloc(cores, sizeof(core_diagram_t));
+	simulator_output_t output = { verbosity, keep_diagram ? core_timing_diagram : NULL, &reader, jobs_ct, jobs_loaded, parse_seconds };
+
+	sim.hooks.arg = &output;
+	sim.hooks.ran = record_span;
+	if (verbosity >= LOG_TICKS)
+		sim.hooks.step = print_step;
+	if (verbosity >= LOG_EVENTS)
+	{
+		sim.hooks.finished = print_finished;
+		sim.hooks.expired = print_expired;
+		sim.hooks.arrived = print_arrived;
+	}
+	if (stream)
+		sim.hooks.arrivals = stream_hook;
+
+	simulation_status_t status = simulation_run(&sim);
+
+	switch (status)
+	{
+		case SIMULATION_DONE:
+			break;
+
+		case SIMULATION_BAD_FINISHED_JOB:
+		case SIMULATION_BAD_EXPIRED_JOB:
+			printf("The %s() selected an invalid job (job_id == %d).\n",
+					status == SIMULATION_BAD_FINISHED_JOB ? "scheduler_job_finished" : "scheduler_quantum_expired", sim.bad_value);
+			print_available_jobs(sim.jobs, sim.active_jobs);
+			return 3;
+
+		case SIMULATION_BAD_CORE:
+			printf("The scheduler_new_job() selected an invalid core (core_id == %d).\n", sim.bad_value);
+			print_available_cores(cores);
+			return 3;
+
+		case SIMULATION_ALL_IDLE:
+			printf("All cores are idle and at least one job remains unscheduled.\n");
+			print_available_jobs(sim.jobs, sim.active_jobs);
+			return 3;
+
+		case SIMULATION_BAD_TRACE:
+			fprintf(stderr, "Illegal file format (streamed traces must be sorted by arrival time).\n");
+			return 2;
+	}
+
+	double run_seconds = seconds_since(&run_start);
+
+	if (verbosity >= LOG_EVENTS)
+	{
+		printf("FINAL TIMING DIAGRAM:\n");
+		for (i = 0; i < cores; i++)
+		{
+			printf("  Core %2d: ", i);
+			diagram_print(stdout, &core_timing_diagram[i]);
+			printf("\n");
+		}
+
+		printf("\n");
+	}
+	printf("Average Waiting Time: %.2f\n", scheduler_ctx_average_waiting_time(ctx));
+	printf("Average Turnaround Time: %.2f\n", scheduler_ctx_average_turnaround_time(ctx));
+	printf("Average Response Time: %.2f\n", scheduler_ctx_average_response_time(ctx));
+	if (aging >= 0)
+		printf("Maximum Waiting Time: %d\n", scheduler_ctx_max_waiting_time(ctx));
+
+	deadline_stats_t deadlines;
+	scheduler_ctx_deadline_stats(ctx, &deadlines);
+	if (deadlines.jobs > 0)
+	{
+		printf("\nDEADLINES (%d job(s) with a deadline):\n", deadlines.jobs);
+		printf("  Missed: %d (%.2f%%)\n", deadlines.misses, 100.0 * deadlines.misses / deadlines.jobs);
+		printf("  Lateness: p50 %d, p90 %d, p99 %d, max %d\n",
+			deadlines.lateness_p50, deadlines.lateness_p90, deadlines.lateness_p99, deadlines.max_lateness);
+		printf("  Total Tardiness: %lld (%.2f per job)\n", deadlines.total_tardiness, (double)deadlines.total_tardiness / deadlines.jobs);
+	}
+
+	if (latency)
+		print_latency(ctx, cores);
+
+	if (count_switches)
+	{
+		long long busy_time = 0, overhead_time = 0;
+
+		printf("\nCONTEXT SWITCHES (switch cost %d, migration cost %d):\n", switch_cost, migration_cost);
+		for (i = 0; i < cores; i++)
+		{
+			core_usage_t usage;
+			scheduler_ctx_core_usage(ctx, i, &usage);
+			busy_time += usage.busy_time;
+			overhead_time += sim.overhead[i];
+			printf("  Core %2d: %lu switch(es), %lu migration(s), %lld time unit(s) of overhead\n",
+				i, sim.switches[i], sim.migrations[i], sim.overhead[i]);
+		}
+		printf("Overhead: %lld of %lld busy time unit(s) (%.2f%%)\n",
+			overhead_time, busy_time, busy_time > 0 ? 100.0 * overhead_time / busy_time : 0.0);
+	}
+
+	if (steal_policy != STEAL_NONE)
+	{
+		printf("\nRUN QUEUES (steal %s):\n", steal_policy == STEAL_HALF ? "half" : "one");
+		for (i = 0; i < cores; i++)
+		{
+			core_stats_t stats;
+			scheduler_ctx_core_stats(ctx, i, &stats);
+			printf("  Core %2d: average length %.2f, max length %d, %lu steal(s) of %lu job(s)\n",
+				i, stats.average_queue_length, stats.max_queue_length, stats.steals, stats.stolen_jobs);
+		}
+		printf("Load Imbalance: average %.2f, max %d\n", scheduler_ctx_average_imbalance(ctx), scheduler_ctx_max_imbalance(ctx));
+	}
+
+	if (gantt_name != NULL && diagram_export_gantt(gantt_name, core_timing_diagram, cores) != 0)
+		fprintf(stderr, "Unable to write Gantt data to \"%s\".\n", gantt_name);
+
+	if (timing)
+	{
+		struct rusage usage;
+		getrusage(RUSAGE_SELF, &usage);
+		fprintf(stderr, "Simulated %d time unit(s) and %ld scheduler event(s) in %.3f s (%.0f units/s, %.0f events/s), peak RSS %ld KB\n",
+				sim.time, sim.events, run_seconds, sim.time / run_seconds, sim.events / run_seconds, usage.ru_maxrss);
+	}
+
+	scheduler_destroy(ctx);
+	simulation_destroy(&sim);
+
+	for (i=0; i < cores; i++)
+		free(core_timing_diagram[i].segments);
+	free(core_timing_diagram);
+	free(sim.trace);
+
+	if (stream)
+	{
+		if (verbosity >= LOG_DEBUG || timing)
+			trace_report(&reader, "Streamed", output.parse_seconds);
+		trace_close(&reader);
+	}
+
+	return 0;
+}
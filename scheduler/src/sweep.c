@@ -0,0 +1,481 @@
+/** @file sweep.c
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <getopt.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "libscheduler/libscheduler.h"
+#include "libsimulation/libsimulation.h"
+#include "libtrace/libtrace.h"
+
+#define SWEEP_MAX_VALUES 64
+
+/**
+  A trace loaded once and shared read-only by every run that uses it.
+*/
+typedef struct _sweep_trace_t
+{
+	const char *file_name;
+	simulation_job_t *jobs; // sorted by arrival time, then job id
+	int count;
+} sweep_trace_t;
+
+/**
+  One point of the sweep and, once it ran, its results.
+*/
+typedef struct _sweep_task_t
+{
+	sweep_trace_t *trace;
+	scheme_t scheme;
+	int cores;
+	int quantum;
+	int aging_period;
+	int switch_cost;
+	int migration_cost;
+
+	const char *error;
+	float waiting_time;
+	float turnaround_time;
+	float response_time;
+	int deadline_misses;
+	int max_waiting_time;
+	int waiting_p99;
+	unsigned long switches;
+	unsigned long migrations;
+} sweep_task_t;
+
+typedef struct _sweep_pool_t
+{
+	sweep_task_t *tasks;
+	int num_tasks;
+	int next_task;
+	pthread_mutex_t lock;
+} sweep_pool_t;
+
+static const char *scheme_names[] = { "fcfs", "sjf", "psjf", "pri", "ppri", "rr", "mlfq", "cfs", "edf" };
+
+void print_usage(char *program_name)
+{
+	fprintf(stderr, "Usage: %s [-j threads] [-c cores,...] [-s schemes,...] [-q quanta,...] [-a periods,...] [-x switch cost] [-m migration cost]\n", program_name);
+	fprintf(stderr, "       [-o output] <input file>...\n");
+	fprintf(stderr, "       %s -j 8 -c 1,2,4 -s fcfs,ppri,rr -q 1,2,4 examples/proc*.csv\n", program_name);
+	fprintf(stderr, "\n");
+	fprintf(stderr, "Runs every combination of input file, scheme, core count and (for rr) quantum\n");
+	fprintf(stderr, "on a pool of threads and writes one CSV table of the average times.\n");
+	fprintf(stderr, "Acceptable schemes are: fcfs, sjf, psjf, pri, ppri, rr, rr#, mlfq, cfs, edf (default: all, quanta 1,2,4)\n");
+	fprintf(stderr, "mlfq and cfs use the simulator's default levels and timing.\n");
+	fprintf(stderr, "-a runs pri and ppri once per aging period instead of with fixed priorities.\n");
+	fprintf(stderr, "-x and -m charge every context switch and migration like the simulator's --switch-cost\n");
+	fprintf(stderr, "and --migration-cost.\n");
+}
+
+/*
+ * Parses a comma separated list of positive numbers.
+ * Returns the number of values, or -1 if the list is malformed.
+ */
+int parse_list(const char *list, int *values)
+{
+	int count = 0;
+	char *end;
+
+	while (*list != '\0')
+	{
+		long value = strtol(list, &end, 10);
+
+		if (end == list || value <= 0 || count == SWEEP_MAX_VALUES || (*end != ',' && *end != '\0'))
+			return -1;
+
+		values[count++] = value;
+		list = (*end == ',') ? end + 1 : end;
+	}
+
+	return count;
+}
+
+/*
+ * Parses a comma separated list of schemes. A quantum given as rr# is stored
+ * in quanta, 0 means the run uses every quantum of the -q list.
+ * Returns the number of schemes, or -1 if the list is malformed.
+ */
+int parse_schemes(const char *list, scheme_t *schemes, int *quanta)
+{
+	int count = 0;
+	char buffer[256];
+	char *saveptr, *name;
+
+	snprintf(buffer, sizeof(buffer), "%s", list);
+	for (name = strtok_r(buffer, ",", &saveptr); name != NULL; name = strtok_r(NULL, ",", &saveptr))
+	{
+		int scheme = -1, quantum = 0;
+
+		if (strcasecmp(name, "FCFS") == 0) { scheme = FCFS; }
+		else if (strcasecmp(name, "SJF") == 0) { scheme = SJF; }
+		else if (strcasecmp(name, "PSJF") == 0) { scheme = PSJF; }
+		else if (strcasecmp(name, "PRI") == 0) { scheme = PRI; }
+		else if (strcasecmp(name, "PPRI") == 0) { scheme = PPRI; }
+		else if (strcasecmp(name, "MLFQ") == 0) { scheme = MLFQ; }
+		else if (strcasecmp(name, "CFS") == 0) { scheme = CFS; }
+		else if (strcasecmp(name, "EDF") == 0) { scheme = EDF; }
+		else if (strncasecmp(name, "RR", 2) == 0)
+		{
+			scheme = RR;
+			if (name[2] != '\0' && (quantum = atoi(name + 2)) <= 0)
+				return -1;
+		}
+
+		if (scheme == -1 || count == SWEEP_MAX_VALUES)
+			return -1;
+
+		schemes[count] = scheme;
+		quanta[count++] = quantum;
+	}
+
+	return count;
+}
+
+/*
+ * Reads a whole trace and orders it by arrival.
+ * Returns 0 on success, -1 if the file cannot be read or is malformed.
+ */
+int load_trace(const char *file_name, sweep_trace_t *trace)
+{
+	trace_t reader;
+	trace_job_t job;
+	int capacity = 1024, status;
+
+	if (trace_open(&reader, file_name) != 0)
+		return -1;
+
+	trace->file_name = file_name;
+	trace->count = 0;
+	trace->jobs = malloc(capacity * sizeof(simulation_job_t));
+
+	while ((status = trace_next(&reader, &job)) == 1)
+	{
+		if (trace->count == capacity)
+		{
+			capacity *= 2;
+			trace->jobs = realloc(trace->jobs, capacity * sizeof(simulation_job_t));
+		}
+
+		simulation_job_t *entry = &trace->jobs[trace->count];
+		entry->job_id = trace->count++;
+		entry->arrival_time = job.arrival_time;
+		entry->run_time = job.run_time;
+		entry->priority = job.priority;
+		entry->deadline = job.deadline;
+		entry->core_id = -1;
+		entry->arrived = 0;
+		entry->last_core = -1;
+	}
+
+	trace_close(&reader);
+	if (status < 0)
+	{
+		free(trace->jobs);
+		return -1;
+	}
+
+	qsort(trace->jobs, trace->count, sizeof(simulation_job_t), simulation_compare_arrival);
+	return 0;
+}
+
+/*
+ * Runs one simulation without any output, event-driven and counting
+ * switches, in the simulator's report order so the averages match its.
+ * Returns NULL on success or a description of what the scheduler did wrong.
+ */
+const char *run_simulation(sweep_task_t *task)
+{
+	sweep_trace_t *trace = task->trace;
+	simulation_job_t *arrivals = malloc(trace->count * sizeof(simulation_job_t));
+	const char *error = NULL;
+	simulation_t sim;
+	int c;
+
+	// The simulation reorders simultaneous arrivals, and the trace is shared
+	memcpy(arrivals, trace->jobs, trace->count * sizeof(simulation_job_t));
+
+	scheduler_ctx_t *ctx = scheduler_create(task->cores, task->scheme, STEAL_NONE);
+	scheduler_ctx_set_aging(ctx, task->aging_period);
+
+	simulation_init(&sim, ctx, task->cores, task->scheme, task->quantum, arrivals, trace->count, 1);
+	sim.event_driven = 1;
+	sim.count_switches = 1;
+	sim.switch_cost = task->switch_cost;
+	sim.migration_cost = task->migration_cost;
+
+	switch (simulation_run(&sim))
+	{
+		case SIMULATION_DONE:
+			break;
+
+		case SIMULATION_BAD_FINISHED_JOB:
+		case SIMULATION_BAD_EXPIRED_JOB:
+			error = "scheduler selected an invalid job";
+			break;
+
+		case SIMULATION_BAD_CORE:
+			error = "scheduler selected an invalid core";
+			break;
+
+		default:
+			error = "all cores idle while jobs remain";
+			break;
+	}
+
+	for (c = 0; c < task->cores; c++)
+	{
+		task->switches += sim.switches[c];
+		task->migrations += sim.migrations[c];
+	}
+
+	if (error == NULL)
+	{
+		task->waiting_time = scheduler_ctx_average_waiting_time(ctx);
+		task->turnaround_time = scheduler_ctx_average_turnaround_time(ctx);
+		task->response_time = scheduler_ctx_average_response_time(ctx);
+
+		deadline_stats_t deadlines;
+		scheduler_ctx_deadline_stats(ctx, &deadlines);
+		task->deadline_misses = deadlines.misses;
+		task->max_waiting_time = scheduler_ctx_max_waiting_time(ctx);
+
+		latency_stats_t waiting;
+		scheduler_ctx_latency_stats(ctx, LATENCY_WAITING, &waiting);
+		task->waiting_p99 = waiting.p99;
+	}
+
+	simulation_destroy(&sim);
+	scheduler_destroy(ctx);
+	free(arrivals);
+	return error;
+}
+
+/*
+ * Worker thread: runs tasks until none are left.
+ */
+void *sweep_worker(void *arg)
+{
+	sweep_pool_t *pool = arg;
+
+	for (;;)
+	{
+		pthread_mutex_lock(&pool->lock);
+		int index = pool->next_task++;
+		pthread_mutex_unlock(&pool->lock);
+
+		if (index >= pool->num_tasks)
+			return NULL;
+
+		pool->tasks[index].error = run_simulation(&pool->tasks[index]);
+	}
+}
+
+double seconds_since(struct timespec *start)
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (now.tv_sec - start->tv_sec) + (now.tv_nsec - start->tv_nsec) / 1e9;
+}
+
+
+int main(int argc, char **argv)
+{
+	int c, i, j, k, q, a;
+	int threads = sysconf(_SC_NPROCESSORS_ONLN);
+	int core_counts[SWEEP_MAX_VALUES] = { 1, 2, 4 }, num_core_counts = 3;
+	int quanta[SWEEP_MAX_VALUES] = { 1, 2, 4 }, num_quanta = 3;
+	scheme_t schemes[SWEEP_MAX_VALUES] = { FCFS, SJF, PSJF, PRI, PPRI, RR, MLFQ, CFS, EDF };
+	int scheme_quanta[SWEEP_MAX_VALUES] = { 0 }, num_schemes = 9;
+	int aging_periods[SWEEP_MAX_VALUES] = { 0 }, num_aging_periods = 1;
+	int switch_cost = 0, migration_cost = 0;
+	char *output_name = NULL;
+
+	/*
+	 * Parse command line options.
+	 */
+	while ((c = getopt(argc, argv, "j:c:s:q:a:x:m:o:")) != -1)
+	{
+		switch (c)
+		{
+			case 'j':
+				if ((threads = atoi(optarg)) <= 0)
+				{
+					fprintf(stderr, "Option -j <threads> requires a positive number.\n");
+					print_usage(argv[0]);
+					return 1;
+				}
+				break;
+
+			case 'c':
+				if ((num_core_counts = parse_list(optarg, core_counts)) <= 0)
+				{
+					fprintf(stderr, "Option -c requires a list of positive core counts. (Eg: -c 1,2,4)\n");
+					print_usage(argv[0]);
+					return 1;
+				}
+				break;
+
+			case 'q':
+				if ((num_quanta = parse_list(optarg, quanta)) <= 0)
+				{
+					fprintf(stderr, "Option -q requires a list of positive quanta. (Eg: -q 1,2,4)\n");
+					print_usage(argv[0]);
+					return 1;
+				}
+				break;
+
+			case 'a':
+				if ((num_aging_periods = parse_list(optarg, aging_periods)) <= 0)
+				{
+					fprintf(stderr, "Option -a requires a list of positive aging periods. (Eg: -a 10,100)\n");
+					print_usage(argv[0]);
+					return 1;
+				}
+				break;
+
+			case 'x':
+			case 'm':
+				if (atoi(optarg) < 0 || optarg[0] < '0' || optarg[0] > '9')
+				{
+					fprintf(stderr, "Option -%c requires a cost of 0 or more time units.\n", c);
+					print_usage(argv[0]);
+					return 1;
+				}
+				*(c == 'x' ? &switch_cost : &migration_cost) = atoi(optarg);
+				break;
+
+			case 's':
+				if ((num_schemes = parse_schemes(optarg, schemes, scheme_quanta)) <= 0)
+				{
+					fprintf(stderr, "Option -s requires a list of schemes. (Eg: -s fcfs,rr,rr8)\n");
+					print_usage(argv[0]);
+					return 1;
+				}
+				break;
+
+			case 'o':
+				output_name = optarg;
+				break;
+
+			default:
+				print_usage(argv[0]);
+				return 1;
+		}
+	}
+
+	if (optind == argc)
+	{
+		fprintf(stderr, "At least one input file is required.\n");
+		print_usage(argv[0]);
+		return 1;
+	}
+
+	FILE *output = stdout;
+	if (output_name != NULL && (output = fopen(output_name, "w")) == NULL)
+	{
+		fprintf(stderr, "Unable to create \"%s\".\n", output_name);
+		return 2;
+	}
+
+	/*
+	 * Load every trace once, then build the Cartesian product of runs.
+	 */
+	int num_traces = argc - optind;
+	sweep_trace_t *traces = malloc(num_traces * sizeof(sweep_trace_t));
+
+	for (i = 0; i < num_traces; i++)
+	{
+		if (load_trace(argv[optind + i], &traces[i]) != 0)
+		{
+			fprintf(stderr, "Unable to read trace \"%s\".\n", argv[optind + i]);
+			return 2;
+		}
+	}
+
+	int max_tasks = num_traces * num_schemes * num_core_counts * num_quanta * num_aging_periods;
+	sweep_pool_t pool = { malloc(max_tasks * sizeof(sweep_task_t)), 0, 0, PTHREAD_MUTEX_INITIALIZER };
+
+	for (i = 0; i < num_traces; i++)
+		for (j = 0; j < num_schemes; j++)
+			for (k = 0; k < num_core_counts; k++)
+				for (q = 0; q < num_quanta; q++)
+					for (a = 0; a < num_aging_periods; a++)
+					{
+						int quantum = 0, aging_period = 0;
+
+						if (schemes[j] == RR)
+							quantum = scheme_quanta[j] ? scheme_quanta[j] : quanta[q];
+						if ((schemes[j] != RR || scheme_quanta[j]) && q > 0)
+							break;
+						if (schemes[j] == PRI || schemes[j] == PPRI)
+							aging_period = aging_periods[a];
+						else if (a > 0)
+							break;
+
+						sweep_task_t *task = &pool.tasks[pool.num_tasks++];
+						memset(task, 0, sizeof(sweep_task_t));
+						task->trace = &traces[i];
+						task->scheme = schemes[j];
+						task->cores = core_counts[k];
+						task->quantum = quantum;
+						task->aging_period = aging_period;
+						task->switch_cost = switch_cost;
+						task->migration_cost = migration_cost;
+					}
+
+	/*
+	 * Run them.
+	 */
+	struct timespec start;
+	clock_gettime(CLOCK_MONOTONIC, &start);
+
+	if (threads > pool.num_tasks)
+		threads = pool.num_tasks;
+
+	pthread_t workers[threads];
+	for (i = 0; i < threads; i++)
+		pthread_create(&workers[i], NULL, sweep_worker, &pool);
+	for (i = 0; i < threads; i++)
+		pthread_join(workers[i], NULL);
+
+	double seconds = seconds_since(&start);
+
+	/*
+	 * Write the results table.
+	 */
+	int failures = 0;
+
+	fprintf(output, "file,scheme,cores,quantum,aging,jobs,waiting,turnaround,response,waiting_p99,max_waiting,deadline_misses,switches,migrations,status\n");
+	for (i = 0; i < pool.num_tasks; i++)
+	{
+		sweep_task_t *task = &pool.tasks[i];
+
+		fprintf(output, "%s,%s,%d,%d,%d,%d,%.2f,%.2f,%.2f,%d,%d,%d,%lu,%lu,%s\n", task->trace->file_name,
+				scheme_names[task->scheme], task->cores, task->quantum, task->aging_period, task->trace->count,
+				task->waiting_time, task->turnaround_time, task->response_time, task->waiting_p99, task->max_waiting_time, task->deadline_misses,
+				task->switches, task->migrations,
+				task->error ? task->error : "ok");
+		if (task->error)
+			failures++;
+	}
+
+	if (output != stdout)
+		fclose(output);
+
+	fprintf(stderr, "Ran %d simulation(s) on %d thread(s) in %.3f s, %d failed.\n", pool.num_tasks, threads, seconds, failures);
+
+	for (i = 0; i < num_traces; i++)
+		free(traces[i].jobs);
+	free(traces);
+	free(pool.tasks);
+
+	return failures ? 3 : 0;
+}
@@ -0,0 +1,248 @@
+/** @file tracegen.c
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <getopt.h>
+
+#include "libtrace/libtrace.h"
+
+/**
+  How job priorities are drawn.
+*/
+typedef struct _priority_dist_t
+{
+	enum {PRIORITY_FIXED = 0, PRIORITY_UNIFORM, PRIORITY_ZIPF} kind;
+	int levels; // priorities are 0 .. levels - 1, 0 being the highest
+	double skew; // Zipf exponent
+	double *cdf; // Zipf cumulative distribution, levels entries
+} priority_dist_t;
+
+static unsigned long long rng_state;
+
+/*
+ * splitmix64 seeding and xorshift64* steps: fast, and the same seed
+ * always produces the same trace on every platform.
+ */
+static void seed_random(unsigned long long seed)
+{
+	unsigned long long z = seed + 0x9E3779B97F4A7C15ULL;
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+	rng_state = (z ^ (z >> 31)) | 1;
+}
+
+/*
+ * Returns a uniform number in (0, 1].
+ */
+static double next_uniform()
+{
+	rng_state ^= rng_state >> 12;
+	rng_state ^= rng_state << 25;
+	rng_state ^= rng_state >> 27;
+	return ((rng_state * 2685821657736338717ULL) >> 11) * (1.0 / 9007199254740992.0) + (1.0 / 9007199254740992.0);
+}
+
+void print_usage(char *program_name)
+{
+	fprintf(stderr, "Usage: %s -n <jobs> [-s seed] [-r rate] [-a alpha] [-m min run] [-M max run] [-p priorities] [-d slack] [-b] [-o output]\n", program_name);
+	fprintf(stderr, "       %s -n 100000 -r 0.3 -a 1.5 -p zipf:8:1.2 -b -o jobs.trace\n", program_name);
+	fprintf(stderr, "\n");
+	fprintf(stderr, "Arrivals are a Poisson process of <rate> jobs per time unit (default 0.5).\n");
+	fprintf(stderr, "Run times are Pareto distributed with shape <alpha> (default 1.5) from <min run> (default 1),\n");
+	fprintf(stderr, "capped at <max run> (default 100000).\n");
+	fprintf(stderr, "Priorities are fixed:P, uniform:K (0 .. K-1) or zipf:K:S (0 most likely); default uniform:8.\n");
+	fprintf(stderr, "With -d every job gets a deadline of its arrival plus its run time times a factor drawn\n");
+	fprintf(stderr, "uniformly from 1 to <slack>; without it the trace has no deadlines.\n");
+	fprintf(stderr, "The trace is written as CSV to stdout or <output>, or as a binary trace with -b (needs -o).\n");
+}
+
+/*
+ * Parses a priority distribution. Returns 0 on success, -1 if malformed.
+ */
+int parse_priorities(const char *spec, priority_dist_t *dist)
+{
+	memset(dist, 0, sizeof(priority_dist_t));
+
+	if (sscanf(spec, "fixed:%d", &dist->levels) == 1)
+		dist->kind = PRIORITY_FIXED;
+	else if (sscanf(spec, "uniform:%d", &dist->levels) == 1 && dist->levels > 0)
+		dist->kind = PRIORITY_UNIFORM;
+	else if (sscanf(spec, "zipf:%d:%lf", &dist->levels, &dist->skew) == 2 && dist->levels > 0 && dist->skew >= 0)
+	{
+		dist->kind = PRIORITY_ZIPF;
+		dist->cdf = malloc(dist->levels * sizeof(double));
+
+		double total = 0.0;
+		for (int k = 0; k < dist->levels; k++)
+			total += dist->cdf[k] = 1.0 / pow(k + 1, dist->skew);
+		for (int k = 0; k < dist->levels; k++)
+			dist->cdf[k] = (k ? dist->cdf[k - 1] : 0.0) + dist->cdf[k] / total;
+	}
+	else
+		return -1;
+
+	return 0;
+}
+
+int next_priority(priority_dist_t *dist)
+{
+	if (dist->kind == PRIORITY_FIXED)
+		return dist->levels;
+	if (dist->kind == PRIORITY_UNIFORM)
+		return (int)(next_uniform() * dist->levels) % dist->levels;
+
+	// Zipf: binary search the cumulative distribution
+	double u = next_uniform();
+	int low = 0, high = dist->levels - 1;
+	while (low < high)
+	{
+		int mid = (low + high) / 2;
+		if (dist->cdf[mid] < u)
+			low = mid + 1;
+		else
+			high = mid;
+	}
+	return low;
+}
+
+
+int main(int argc, char **argv)
+{
+	int c;
+	long jobs = -1, i;
+	unsigned long long seed = 1;
+	double rate = 0.5, alpha = 1.5, slack = 0.0;
+	int min_run = 1, max_run = 100000, binary = 0;
+	char *output_name = NULL;
+	priority_dist_t priorities;
+
+	parse_priorities("uniform:8", &priorities);
+
+	while ((c = getopt(argc, argv, "n:s:r:a:m:M:p:d:bo:")) != -1)
+	{
+		switch (c)
+		{
+			case 'n': jobs = atol(optarg); break;
+			case 's': seed = strtoull(optarg, NULL, 10); break;
+			case 'r': rate = atof(optarg); break;
+			case 'a': alpha = atof(optarg); break;
+			case 'm': min_run = atoi(optarg); break;
+			case 'M': max_run = atoi(optarg); break;
+			case 'd': slack = atof(optarg); break;
+			case 'b': binary = 1; break;
+			case 'o': output_name = optarg; break;
+
+			case 'p':
+				if (parse_priorities(optarg, &priorities) != 0)
+				{
+					fprintf(stderr, "Unknown priority distribution \"%s\".\n", optarg);
+					print_usage(argv[0]);
+					return 1;
+				}
+				break;
+
+			default:
+				print_usage(argv[0]);
+				return 1;
+		}
+	}
+
+	if (jobs < 0 || rate <= 0 || alpha <= 0 || min_run <= 0 || max_run < min_run)
+	{
+		fprintf(stderr, "Options -n, -r, -a, -m and -M require positive numbers (and -M >= -m).\n");
+		print_usage(argv[0]);
+		return 1;
+	}
+
+	if (slack != 0.0 && slack < 1.0)
+	{
+		fprintf(stderr, "Option -d requires a slack of at least 1.\n");
+		print_usage(argv[0]);
+		return 1;
+	}
+
+	if (binary && output_name == NULL)
+	{
+		fprintf(stderr, "Binary traces (-b) need an output file (-o).\n");
+		print_usage(argv[0]);
+		return 1;
+	}
+
+	FILE *out = stdout;
+	if (output_name != NULL && (out = fopen(output_name, binary ? "wb" : "w")) == NULL)
+	{
+		fprintf(stderr, "Unable to create \"%s\".\n", output_name);
+		return 2;
+	}
+
+	trace_header_t header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, TRACE_MAGIC, sizeof(header.magic));
+	header.version = TRACE_VERSION;
+	header.record_size = sizeof(trace_record_t);
+	header.flags = TRACE_SORTED;
+	header.checksum = TRACE_CHECKSUM_SEED;
+
+	if (binary)
+		fwrite(&header, sizeof(header), 1, out);
+	else if (slack > 0.0)
+		fprintf(out, "\"Arrival time\",\"Run time\",\"Priority\",\"Deadline\"\n");
+	else
+		fprintf(out, "\"Arrival time\",\"Run time\",\"Priority\"\n");
+
+	seed_random(seed);
+
+	double clock = 0.0;
+	for (i = 0; i < jobs; i++)
+	{
+		trace_record_t record;
+
+		// Exponential inter-arrival times make the arrivals a Poisson process
+		clock += -log(next_uniform()) / rate;
+		if (clock > 2147483647.0)
+		{
+			fprintf(stderr, "Arrival times overflow after %ld job(s); use a higher rate.\n", i);
+			return 2;
+		}
+
+		double run = ceil(min_run * pow(next_uniform(), -1.0 / alpha));
+		record.arrival_time = (int32_t)clock;
+		record.run_time = run > max_run ? max_run : (int32_t)run;
+		record.priority = next_priority(&priorities);
+		record.deadline = -1;
+		if (slack > 0.0)
+		{
+			double deadline = clock + ceil(record.run_time * (1.0 + (slack - 1.0) * next_uniform()));
+			record.deadline = deadline > 2147483647.0 ? 2147483647 : (int32_t)deadline;
+		}
+
+		if (binary)
+		{
+			header.checksum = trace_checksum_update(header.checksum, &record, sizeof(record));
+			fwrite(&record, sizeof(record), 1, out);
+		}
+		else if (slack > 0.0)
+			fprintf(out, "%d,%d,%d,%d\n", record.arrival_time, record.run_time, record.priority, record.deadline);
+		else
+			fprintf(out, "%d,%d,%d\n", record.arrival_time, record.run_time, record.priority);
+	}
+
+	if (binary)
+	{
+		header.count = jobs;
+		fseek(out, 0, SEEK_SET);
+		fwrite(&header, sizeof(header), 1, out);
+	}
+
+	if (out != stdout && fclose(out) != 0)
+	{
+		fprintf(stderr, "Unable to write \"%s\".\n", output_name);
+		return 2;
+	}
+
+	free(priorities.cdf);
+	return 0;
+}